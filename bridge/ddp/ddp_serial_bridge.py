@@ -19,6 +19,7 @@ from http.server import HTTPServer, BaseHTTPRequestHandler
 from datetime import datetime
 import json
 import mimetypes
+import struct
 
 # COBS encode/decode (fixed implementation)
 def cobs_encode(data: bytes) -> bytes:
@@ -72,6 +73,126 @@ def cobs_decode(data: bytes) -> bytes:
     return bytes(result)
 
 
+# DDP config packets and clock sync; binary commands use 252, not the spec's
+# JSON config ID 250 (see DDPProtocol.h)
+DDP_ID_CONFIG = 252
+DDP_CONFIG_TIME_SYNC = 0x03
+TIME_SYNC_INTERVAL = 2.0  # seconds
+
+# DDP query/reply status (see DDPProtocol.h)
+DDP_ID_STATUS = 253  # Not the spec's JSON status ID 251 (see DDPProtocol.h)
+DDP_FLAG_REPLY = 0x04
+DDP_FLAG_QUERY = 0x02
+DDP_FLAG_PUSH = 0x01
+DDP_STATUS_VERSION = 1
+STATUS_HEADER = struct.Struct('>BBBBIIIIHH')
+STATUS_CHANNEL = struct.Struct('>BBH')
+STATUS_POLL_INTERVAL = 1.0  # seconds
+
+# Binary telemetry record (see Telemetry.h); fields are only ever appended
+DDP_FRAME_TELEMETRY = 0x01
+TELEMETRY_HEADER = struct.Struct('>BBH')
+TELEMETRY_FIELDS = (
+    'uptime_ms', 'packets_received', 'packets_processed',
+    'drops_queue_full', 'drops_parse', 'drops_stale', 'packets_rejected',
+    'frames_shown', 'frames_incomplete',
+    'sequence_gaps', 'sequence_missing', 'sequence_duplicates', 'sequence_late',
+    'frames_scheduled', 'frames_late',
+    'output_shows', 'output_waits', 'output_wait_us', 'render_us',
+    'queue_usage', 'frame_rate',
+)
+TELEMETRY_RECORD = struct.Struct('>BBH' + 'I' * 19 + 'HH')
+# Appended in version 2: drop and reject counts by reason
+TELEMETRY_FIELDS_V2 = ('drops_cobs', 'rejected_dest', 'rejected_range', 'rejected_config')
+TELEMETRY_V2 = struct.Struct('>4I')
+# Appended in version 3: log records dropped because a ring was full
+TELEMETRY_FIELDS_V3 = ('log_dropped',)
+TELEMETRY_V3 = struct.Struct('>I')
+# Appended in version 4: received bytes lost to an RX source overrun
+TELEMETRY_FIELDS_V4 = ('rx_overrun_bytes',)
+TELEMETRY_V4 = struct.Struct('>I')
+
+# Stage timing frames, sent after each telemetry record when built with DDP_PROFILE
+DDP_FRAME_PROFILE = 0x02
+PROFILE_HEADER = struct.Struct('>BBHBBIIII')
+PROFILE_STAGES = ('queue_write', 'queue_wait', 'parse', 'apply', 'push_hold', 'render', 'show', 'end_to_end')
+
+
+def parse_status_reply(payload):
+    """Decode the payload of a status reply into a dict, None if not understood"""
+    if len(payload) < STATUS_HEADER.size or payload[0] != DDP_STATUS_VERSION:
+        return None
+    (version, channel_count, mapping_mode, output_engine, packets_received, packets_processed,
+     packets_dropped, frames_shown, queue_usage, frame_rate) = STATUS_HEADER.unpack_from(payload)
+    channels = []
+    for i in range(channel_count):
+        offset = STATUS_HEADER.size + i * STATUS_CHANNEL.size
+        if offset + STATUS_CHANNEL.size > len(payload):
+            return None
+        pin, bytes_per_pixel, num_leds = STATUS_CHANNEL.unpack_from(payload, offset)
+        channels.append({'pin': pin, 'bytes_per_pixel': bytes_per_pixel, 'num_leds': num_leds})
+    return {
+        'version': version,
+        'mapping_mode': mapping_mode,
+        'output_engine': output_engine,
+        'packets_received': packets_received,
+        'packets_processed': packets_processed,
+        'packets_dropped': packets_dropped,
+        'frames_shown': frames_shown,
+        'queue_usage': queue_usage / 10.0,
+        'frame_rate': frame_rate / 10.0,
+        'channels': channels,
+    }
+
+
+def parse_telemetry(frame):
+    """Decode a telemetry frame into a dict, None if it is not one"""
+    if len(frame) < TELEMETRY_HEADER.size or frame[0] != DDP_FRAME_TELEMETRY:
+        return None
+    _, version, length = TELEMETRY_HEADER.unpack_from(frame)
+    if length != len(frame) or length < TELEMETRY_RECORD.size:
+        return None
+    values = TELEMETRY_RECORD.unpack_from(frame)[3:]
+    telemetry = dict(zip(TELEMETRY_FIELDS, values))
+    if length >= TELEMETRY_RECORD.size + TELEMETRY_V2.size:
+        telemetry.update(zip(TELEMETRY_FIELDS_V2, TELEMETRY_V2.unpack_from(frame, TELEMETRY_RECORD.size)))
+    v3_offset = TELEMETRY_RECORD.size + TELEMETRY_V2.size
+    if length >= v3_offset + TELEMETRY_V3.size:
+        telemetry.update(zip(TELEMETRY_FIELDS_V3, TELEMETRY_V3.unpack_from(frame, v3_offset)))
+    v4_offset = v3_offset + TELEMETRY_V3.size
+    if length >= v4_offset + TELEMETRY_V4.size:
+        telemetry.update(zip(TELEMETRY_FIELDS_V4, TELEMETRY_V4.unpack_from(frame, v4_offset)))
+    telemetry['version'] = version
+    telemetry['queue_usage'] /= 10.0
+    telemetry['frame_rate'] /= 10.0
+    return telemetry
+
+
+def parse_profile(frame):
+    """Decode a stage timing frame into (stage name, dict), None if it is not one"""
+    if len(frame) < PROFILE_HEADER.size or frame[0] != DDP_FRAME_PROFILE:
+        return None
+    _, version, length, stage, buckets, count, min_us, avg_us, max_us = PROFILE_HEADER.unpack_from(frame)
+    if length != len(frame) or length < PROFILE_HEADER.size + 4 * buckets:
+        return None
+    histogram = list(struct.unpack_from(f'>{buckets}I', frame, PROFILE_HEADER.size))
+    name = PROFILE_STAGES[stage] if stage < len(PROFILE_STAGES) else f'stage_{stage}'
+    return name, {
+        'count': count,
+        'min_us': min_us,
+        'avg_us': avg_us,
+        'max_us': max_us,
+        'histogram': histogram,  # Bucket n: [2^(n-1), 2^n) us, bucket 0: 0 us
+    }
+
+
+def ddp_timecode(t=None):
+    """DDP timecode for a Unix time: middle 32 bits of the NTP timestamp (16.16 seconds)"""
+    if t is None:
+        t = time.time()
+    return int(t * 65536) & 0xFFFFFFFF
+
+
 class DDPBridge:
     def __init__(self, serial_port, baud=921600, udp_port=4048, web_port=4000, num_leds=43):
         self.serial_port = serial_port
@@ -105,6 +226,15 @@ class DDPBridge:
         # Sequence counter for DDP packets
         self.sequence = 0
 
+        # Serial writes come from several threads; frames must not interleave
+        self.serial_lock = threading.Lock()
+
+        # Latest status reply and telemetry record from the Pico
+        self.pico_status = None
+        self.status_replies = 0
+        self.pico_telemetry = None
+        self.pico_profile = {}
+
         # Log buffer for web dashboard
         self.log_buffer = deque(maxlen=100)
         self.log_lock = threading.Lock()
@@ -161,8 +291,15 @@ class DDPBridge:
             return False
     
     def serial_rx_thread(self):
-        """Read serial data"""
+        """Read serial data
+
+        The link carries text lines and binary frames. Frames are sent as
+        0x00 <COBS> 0x00, so zero bytes alternate between opening and
+        closing a frame. A segment that does not decode as a frame is text,
+        and the zero after it is taken as the opening of the next frame.
+        """
         buffer = bytearray()
+        in_frame = False
         
         while self.running:
             try:
@@ -171,30 +308,87 @@ class DDPBridge:
                     buffer.extend(data)
                     self.bytes_rx += len(data)
                     
-                    # Process complete lines (Pico debug messages)
-                    while b'\n' in buffer:
-                        line_end = buffer.index(b'\n')
-                        line = bytes(buffer[:line_end]).decode('utf-8', errors='ignore').strip()
-                        buffer = buffer[line_end + 1:]
-                        
-                        if line:
-                            # Only log lines that start with [DDPico] prefix
-                            if line.startswith('[DDPico]'):
-                                self.packets_rx += 1
-                                # Forward Pico messages to web app
-                                self.log(line, to_console=False)
-                                self.last_activity = time.time()
-                    
-                    # Process COBS frames silently (DDP data packets)
                     while b'\x00' in buffer:
                         delim_idx = buffer.index(b'\x00')
+                        segment = bytes(buffer[:delim_idx])
                         buffer = buffer[delim_idx + 1:]
+                        if in_frame and self.handle_serial_frame(segment):
+                            in_frame = False
+                        else:
+                            self.handle_serial_text(segment)
+                            in_frame = True
+                    
+                    # Complete lines outside a frame can be handled straight away
+                    if not in_frame:
+                        while b'\n' in buffer:
+                            line_end = buffer.index(b'\n')
+                            self.handle_serial_text(bytes(buffer[:line_end]))
+                            buffer = buffer[line_end + 1:]
                 
                 time.sleep(0.001)
             except Exception as e:
                 self.log(f"[ERROR] Serial RX: {e}")
                 time.sleep(0.1)
     
+    def handle_serial_text(self, data):
+        """Forward Pico log lines to the web app"""
+        for raw in data.split(b'\n'):
+            line = raw.decode('utf-8', errors='ignore').strip()
+            # Only log lines that start with [DDPico] prefix
+            if line.startswith('[DDPico]'):
+                self.packets_rx += 1
+                self.log(line, to_console=False)
+                self.last_activity = time.time()
+    
+    def handle_serial_frame(self, encoded):
+        """Handle a binary frame from the Pico, False if it is not one"""
+        if not encoded:
+            return False
+        packet = cobs_decode(encoded)
+        telemetry = parse_telemetry(packet)
+        if telemetry is not None:
+            self.pico_telemetry = telemetry
+            self.last_activity = time.time()
+            return True
+        profile = parse_profile(packet)
+        if profile is not None:
+            name, stats = profile
+            self.pico_profile[name] = stats
+            return True
+        if len(packet) < 10:
+            return False
+        flags = packet[0]
+        length = (packet[8] << 8) | packet[9]
+        if ((flags & 0xC0) != 0x40 or (flags & (DDP_FLAG_REPLY | DDP_FLAG_PUSH)) != DDP_FLAG_REPLY or
+                packet[3] != DDP_ID_STATUS or len(packet) != 10 + length):
+            return False
+        status = parse_status_reply(packet[10:])
+        if status is not None:
+            self.pico_status = status
+            self.status_replies += 1
+        return True
+    
+    def send_status_query(self):
+        """Ask the Pico for a status reply"""
+        packet = bytes([
+            0x40 | DDP_FLAG_QUERY, 0x00, 0x01, DDP_ID_STATUS,
+            0, 0, 0, 0,
+            0, 0,
+        ])
+        with self.serial_lock:
+            self.ser.write(cobs_encode(packet))
+            self.ser.flush()
+    
+    def status_poll_thread(self):
+        """Poll the Pico's status"""
+        while self.running:
+            try:
+                if self.ser:
+                    self.send_status_query()
+            except Exception as e:
+                self.log(f"[ERROR] Status query failed: {e}")
+            time.sleep(STATUS_POLL_INTERVAL)
+    
     def udp_rx_thread(self):
         """Receive UDP packets and buffer for processing"""
         consecutive_errors = 0
@@ -292,8 +486,9 @@ class DDPBridge:
         encoded = cobs_encode(packet)
 
         try:
-            bytes_written = self.ser.write(encoded)
-            self.ser.flush()
+            with self.serial_lock:
+                bytes_written = self.ser.write(encoded)
+                self.ser.flush()
             self.packets_tx += 1
             self.bytes_tx += len(packet)
             return True
@@ -334,8 +529,9 @@ class DDPBridge:
                         # Not a full RGB frame, send as is
                         encoded = cobs_encode(data)
                         try:
-                            self.ser.write(encoded)
-                            self.ser.flush()
+                            with self.serial_lock:
+                                self.ser.write(encoded)
+                                self.ser.flush()
                             self.packets_tx += 1
                             self.bytes_tx += len(data)
                         except Exception as e:
@@ -343,6 +539,29 @@ class DDPBridge:
 
             time.sleep(0.001)  # Small delay to prevent tight loop
 
+    def time_sync_thread(self):
+        """Keep the Pico's presentation clock synced to this host's clock
+
+        Packets sent with the DDP timecode flag are shown when the synced
+        clock reaches their timecode, so controllers on the same host show
+        their frames in lockstep.
+        """
+        while self.running:
+            payload = bytes([DDP_CONFIG_TIME_SYNC, 0]) + ddp_timecode().to_bytes(4, 'big')
+            packet = bytes([
+                0x40, 0x00, 0x01, DDP_ID_CONFIG,
+                0, 0, 0, 0,
+                (len(payload) >> 8) & 0xFF, len(payload) & 0xFF,
+            ]) + payload
+            try:
+                if self.ser:
+                    with self.serial_lock:
+                        self.ser.write(cobs_encode(packet))
+                        self.ser.flush()
+            except Exception as e:
+                self.log(f"[ERROR] Time sync failed: {e}")
+            time.sleep(TIME_SYNC_INTERVAL)
+
     def stats_thread(self):
         """Print stats periodically"""
         while self.running:
@@ -396,8 +615,9 @@ class DDPBridge:
             
             # Encode and send
             encoded = cobs_encode(packet)
-            self.ser.write(encoded)
-            self.ser.flush()
+            with self.serial_lock:
+                self.ser.write(encoded)
+                self.ser.flush()
             
             self.log(f"[TEST] Sent {['Red', 'Green', 'Blue', 'Yellow', 'Magenta'][color_idx]} to {num_leds} LEDs (flags: 0x{flags:02X})")
             time.sleep(1.0)
@@ -411,8 +631,9 @@ class DDPBridge:
             (data_len >> 8) & 0xFF, data_len & 0xFF,  # 16-bit length
         ]) + pixel_data
         encoded = cobs_encode(packet)
-        self.ser.write(encoded)
-        self.ser.flush()
+        with self.serial_lock:
+            self.ser.write(encoded)
+            self.ser.flush()
         
         self.log("[TEST] Test sequence complete - LEDs cleared")
     
@@ -432,6 +653,8 @@ class DDPBridge:
             threading.Thread(target=self.udp_rx_thread, daemon=True),
             threading.Thread(target=self.tweening_thread, daemon=True),
             threading.Thread(target=self.stats_thread, daemon=True),
+            threading.Thread(target=self.time_sync_thread, daemon=True),
+            threading.Thread(target=self.status_poll_thread, daemon=True),
         ]
         
         for t in threads:
@@ -476,6 +699,9 @@ class WebHandler(BaseHTTPRequestHandler):
             elif self.path == '/settings':
                 self.serve_settings()
 
+            elif self.path == '/status':
+                self.serve_status()
+
             elif self.path == '/events':
                 self.serve_events()
 
@@ -588,6 +814,19 @@ class WebHandler(BaseHTTPRequestHandler):
         except (ConnectionAbortedError, ConnectionResetError, BrokenPipeError):
             pass  # Client disconnected
 
+    def serve_status(self):
+        """Serve the latest Pico status reply as JSON"""
+        status = {
+            'replies': self.bridge.status_replies,
+            'pico': self.bridge.pico_status,
+            'telemetry': self.bridge.pico_telemetry,
+            'profile': self.bridge.pico_profile,
+        }
+        self.send_response(200)
+        self.send_header('Content-type', 'application/json')
+        self.end_headers()
+        self.wfile.write(json.dumps(status).encode())
+
     def serve_settings(self):
         """Serve current tweening settings as JSON"""
         with self.bridge.settings_lock:
@@ -0,0 +1,119 @@
+/**
+ * COBS decode benchmark
+ *
+ * Decodes the same encoded stream with processByte(), as core1Loop() did
+ * with one Serial.read() per byte, and with processBlock() on 512-byte
+ * blocks, as it does now (DDP_RX_BLOCK_SIZE), and prints MB/s of encoded
+ * input for each. Two kinds of payload: pixel-like data with rare zeros
+ * (long COBS runs) and data with one zero byte in eight (short runs).
+ *
+ * Built by firmware/CMakeLists.txt; not part of ctest.
+ *
+ * Usage:
+ *   ./bench_cobs [frames]   (default 3000)
+ */
+
+#include <Platform.h>
+#include <COBSEncoder.h>
+#include <COBSDecoder.h>
+
+#define BENCH_FRAME_SIZE 1400
+#define BENCH_BLOCK_SIZE 512
+#define BENCH_ROUNDS 20
+
+static std::vector<uint8_t> buildStream(uint32_t frames, uint32_t zeroOdds) {
+    std::vector<uint8_t> stream;
+    uint8_t frame[BENCH_FRAME_SIZE];
+    uint32_t seed = 1;
+    for (uint32_t f = 0; f < frames; f++) {
+        for (size_t i = 0; i < sizeof(frame); i++) {
+            seed = seed * 1103515245u + 12345u;
+            uint32_t r = seed >> 8;
+            frame[i] = (r % zeroOdds == 0) ? 0 : (uint8_t)(1 + (r >> 8) % 255);
+        }
+        size_t start = stream.size();
+        stream.resize(start + COBSEncoder::maxEncodedLength(sizeof(frame)) + 1);
+        size_t encoded = COBSEncoder::encode(frame, sizeof(frame), stream.data() + start);
+        stream[start + encoded] = 0x00;
+        stream.resize(start + encoded + 1);
+    }
+    return stream;
+}
+
+/**
+ * Decode the stream a byte at a time
+ * @return Frames decoded
+ */
+static uint32_t decodeBytes(COBSDecoder& decoder, const std::vector<uint8_t>& stream) {
+    uint32_t frames = 0;
+    for (uint8_t byte : stream) {
+        if (decoder.processByte(byte)) {
+            frames++;
+        }
+    }
+    return frames;
+}
+
+/**
+ * Decode the stream in fixed-size blocks
+ * @return Frames decoded
+ */
+static uint32_t decodeBlocks(COBSDecoder& decoder, const std::vector<uint8_t>& stream) {
+    uint32_t frames = 0;
+    for (size_t pos = 0; pos < stream.size(); pos += BENCH_BLOCK_SIZE) {
+        const uint8_t* data = stream.data() + pos;
+        size_t remaining = min((size_t)BENCH_BLOCK_SIZE, stream.size() - pos);
+        while (remaining > 0) {
+            bool frameDecoded;
+            size_t consumed = decoder.processBlock(data, remaining, frameDecoded);
+            frames += frameDecoded;
+            data += consumed;
+            remaining -= consumed;
+        }
+    }
+    return frames;
+}
+
+/**
+ * Time BENCH_ROUNDS passes over the stream
+ * @return MB/s of encoded input, 0 if a pass lost frames
+ */
+static double measure(uint32_t (*run)(COBSDecoder&, const std::vector<uint8_t>&),
+                      const std::vector<uint8_t>& stream, uint32_t frames) {
+    COBSDecoder decoder(2048, COBSDecoder::MODE_BUFFERED);
+    uint32_t startUs = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        if (run(decoder, stream) != frames) {
+            return 0;
+        }
+    }
+    uint32_t elapsedUs = max(micros() - startUs, (uint32_t)1);
+    return (double)stream.size() * BENCH_ROUNDS / elapsedUs;
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = argc > 1 ? strtoul(argv[1], nullptr, 10) : 3000;
+
+    const struct {
+        const char* name;
+        uint32_t zeroOdds;
+    } payloads[] = {
+        {"pixel-like data (rare zeros)", 256},
+        {"1-in-8 zero bytes", 8},
+    };
+
+    printf("%u frames of %u bytes, %u-byte blocks, MB/s of encoded input\n", frames, BENCH_FRAME_SIZE,
+           BENCH_BLOCK_SIZE);
+    for (const auto& payload : payloads) {
+        std::vector<uint8_t> stream = buildStream(frames, payload.zeroOdds);
+        double byByte = measure(decodeBytes, stream, frames);
+        double byBlock = measure(decodeBlocks, stream, frames);
+        if (byByte == 0 || byBlock == 0) {
+            printf("%s: frames lost\n", payload.name);
+            return 1;
+        }
+        printf("  %-30s processByte %7.0f   processBlock %7.0f   (x%.1f)\n", payload.name, byByte, byBlock,
+               byBlock / byByte);
+    }
+    return 0;
+}
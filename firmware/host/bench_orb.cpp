@@ -0,0 +1,67 @@
+/**
+ * Orb pixel write benchmark
+ *
+ * Fills a 50-LED GRB strip from RGB data and prints pixels/s for each
+ * write path the output stage has used:
+ * - pixelSet() per pixel, as applyPixelData() did: Color() packs the
+ *   pixel, setPixelColor() unpacks it, scales it by the strip brightness
+ *   and reorders it
+ * - pixelsWriteDithered() on the 8.8 front buffer, as the output stage
+ *   does now: scale, dither and reorder in one loop over the strip buffer
+ *
+ * On the host the strip is a CaptureStrip, whose setPixelColor() mirrors
+ * Adafruit_NeoPixel's, so the ratio rather than the absolute rate is what
+ * carries over to the board.
+ *
+ * Built by firmware/CMakeLists.txt; not part of ctest.
+ *
+ * Usage:
+ *   ./bench_orb [refreshes]   (default 200000)
+ */
+
+#include <Platform.h>
+#include <Orb.h>
+
+#define BENCH_LEDS 50
+
+int main(int argc, char** argv) {
+    uint32_t refreshes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+
+    Orb* orb = Orb::create(BENCH_LEDS, 16, NEO_GRB + NEO_KHZ800);
+    uint8_t rgb[BENCH_LEDS * 3];
+    uint16_t levels[BENCH_LEDS * 3];
+    uint8_t residual[BENCH_LEDS * 3] = {};
+    for (uint16_t i = 0; i < BENCH_LEDS * 3; i++) {
+        rgb[i] = (uint8_t)(i * 5 + 1);
+        levels[i] = rgb[i] << 8;
+    }
+    // Same limiter scale on both paths
+    const uint8_t brightness = 101;
+    const uint16_t scale = brightness + 1;
+
+    uint32_t startUs = micros();
+    for (uint32_t r = 0; r < refreshes; r++) {
+        orb->setBrightness(brightness);
+        for (uint16_t i = 0; i < BENCH_LEDS; i++) {
+            orb->pixelSet(i, rgb[i * 3], rgb[i * 3 + 1], (uint8_t)(rgb[i * 3 + 2] + r));
+        }
+    }
+    uint32_t pixelSetUs = max(micros() - startUs, (uint32_t)1);
+    uint32_t check = orb->getPixels()[0];
+
+    startUs = micros();
+    for (uint32_t r = 0; r < refreshes; r++) {
+        levels[2] += 0x100;
+        orb->pixelsWriteDithered(0, levels, BENCH_LEDS, scale, residual);
+    }
+    uint32_t ditheredUs = max(micros() - startUs, (uint32_t)1);
+    check += orb->getPixels()[0];
+
+    double pixels = (double)refreshes * BENCH_LEDS;
+    printf("%u refreshes of %u pixels (check %u), Mpixels/s:\n", refreshes, BENCH_LEDS, check);
+    printf("  pixelSet() per pixel    %7.1f\n", pixels / pixelSetUs);
+    printf("  pixelsWriteDithered()   %7.1f   (x%.1f)\n", pixels / ditheredUs,
+           (double)pixelSetUs / ditheredUs);
+    delete orb;
+    return 0;
+}
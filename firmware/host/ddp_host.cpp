@@ -0,0 +1,246 @@
+/**
+ * DDPico host driver
+ *
+ * Runs the DDPController pipeline as a desktop program on the host
+ * platform layer (lib/Platform): COBS decode on a thread standing in for
+ * Core 1, then queue, parse, apply, limiter and show on the main thread,
+ * with the strips captured in memory instead of sent.
+ *
+ * Input is the byte stream the bridge writes to the serial port (COBS
+ * frames, each ending in 0x00), read from a file, or a generated test
+ * pattern when no file is given. Prints throughput, the controller's
+ * counters and a checksum of what each strip showed last. For the
+ * generated pattern it also checks that every packet was processed and
+ * that each strip shows the last frame, and exits non-zero if not.
+ *
+ * Built by firmware/CMakeLists.txt and run by ctest.
+ *
+ * Usage:
+ *   ./ddp_host [capture.bin]   replay a captured serial stream
+ *   ./ddp_host -n 5000         generate 5000 frames (default 1000)
+ */
+
+#include <Platform.h>
+#include <Orb.h>
+#include <DDPController.h>
+
+// Same layout as the board (src/main.cpp)
+const LEDChannel channelConfigs[] = {
+    {43, 16, NEO_GRB + NEO_KHZ800},
+    {50, 17, NEO_GRB + NEO_KHZ800},
+    {50, 18, NEO_GRB + NEO_KHZ800},
+    {50, 19, NEO_GRB + NEO_KHZ800},
+    {50, 13, NEO_GRB + NEO_KHZ800},
+    {50, 12, NEO_GRB + NEO_KHZ800},
+    {50, 11, NEO_GRB + NEO_KHZ800},
+    {50, 10, NEO_GRB + NEO_KHZ800}
+};
+const uint8_t numChannels = sizeof(channelConfigs) / sizeof(channelConfigs[0]);
+
+// Bytes handed to the serial link per write. The driver writes only while
+// the previous write has been read and the packet queue is at most half
+// full, like a host pacing its output, so the run measures the pipeline
+// rather than queue overruns.
+#define HOST_WRITE_SIZE 512
+#define HOST_MAX_IN_FLIGHT (DDP_PACKET_POOL_SLOTS / 2)
+
+// Time the pipeline gets to show the last frame once the queue is empty
+#define HOST_DRAIN_MS 20
+
+/**
+ * Append one packet as the bridge sends it: COBS encoded, 0x00 terminated
+ */
+static void appendFrame(std::vector<uint8_t>& stream, const uint8_t* packet, size_t length) {
+    size_t start = stream.size();
+    stream.resize(start + COBSEncoder::maxEncodedLength(length) + 1);
+    size_t encoded = COBSEncoder::encode(packet, length, stream.data() + start);
+    stream[start + encoded] = 0x00;
+    stream.resize(start + encoded + 1);
+}
+
+/**
+ * Get the level the generator sent for one element of a frame
+ */
+static uint8_t patternLevel(uint32_t frame, uint8_t channel, uint16_t element) {
+    return (uint8_t)(frame + element * 5 + channel * 32);
+}
+
+/**
+ * Generate a moving gradient, one pushed RGB packet per channel and frame
+ */
+static std::vector<uint8_t> generatePattern(uint32_t frames) {
+    std::vector<uint8_t> stream;
+    uint8_t packet[DDP_HEADER_SIZE + DDP_MAX_PACKET_SIZE];
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint8_t c = 0; c < numChannels; c++) {
+            uint16_t length = channelConfigs[c].numLEDs * 3;
+            packet[0] = DDP_FLAG_VER1 | DDP_FLAG_PUSH;
+            packet[1] = f % 15 + 1;
+            packet[2] = DDP_TYPE_RGB8;
+            packet[3] = c + 1;
+            DDPProtocol::putBE32(packet + 4, 0);
+            DDPProtocol::putBE16(packet + 8, length);
+            for (uint16_t i = 0; i < length; i++) {
+                packet[DDP_HEADER_SIZE + i] = patternLevel(f, c, i);
+            }
+            appendFrame(stream, packet, DDP_HEADER_SIZE + length);
+        }
+    }
+    return stream;
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& stream) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        stream.insert(stream.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * Check the counters and the shown bytes after the generated pattern
+ * Each strip must show the last frame scaled by the limiter; dithering
+ * may round any element up by one.
+ * @return Number of failed checks
+ */
+static uint32_t verifyPattern(const DDPController& controller, uint32_t frames) {
+    uint32_t failures = 0;
+    RxCounters rx;
+    ProcessCounters process;
+    controller.getCounters(rx, process);
+    uint32_t packets = frames * numChannels;
+    uint32_t drops = rx.dropsQueueFull + rx.dropsCobs + process.dropsParse + process.dropsStale;
+    uint32_t rejects = process.rejectedDest + process.rejectedRange + process.rejectedConfig;
+    if (rx.packetsReceived != packets || process.packetsProcessed != packets || drops || rejects) {
+        printf("FAIL: %u packets sent, %u received, %u processed, %u dropped, %u rejected\n",
+               packets, rx.packetsReceived, process.packetsProcessed, drops, rejects);
+        failures++;
+    }
+
+    const LEDChannel* channels = controller.getChannels();
+    for (uint8_t c = 0; c < numChannels; c++) {
+        const CaptureStrip* strip = CaptureStrip::find(channelConfigs[c].pin);
+        if (!strip) {
+            printf("FAIL: no strip on GP%u\n", channelConfigs[c].pin);
+            failures++;
+            continue;
+        }
+        // One show from Orb::begin(), then one per frame
+        if (strip->getShowCount() != frames + 1) {
+            printf("FAIL: channel %u shown %u times, expected %u\n", c + 1, strip->getShowCount(), frames + 1);
+            failures++;
+        }
+
+        neoPixelType type = channelConfigs[c].format;
+        const uint8_t offsets[3] = {(uint8_t)((type >> 4) & 3), (uint8_t)((type >> 2) & 3), (uint8_t)(type & 3)};
+        uint8_t stride = strip->getShownBytes() / channelConfigs[c].numLEDs;
+        uint16_t scale = channels[c].frontScale;
+        for (uint16_t p = 0; p < channelConfigs[c].numLEDs; p++) {
+            for (uint8_t k = 0; k < 3; k++) {
+                uint32_t expected = (patternLevel(frames - 1, c, p * 3 + k) * scale) >> 8;
+                uint8_t shown = strip->getShown()[p * stride + offsets[k]];
+                if (shown < expected || shown > expected + 1) {
+                    printf("FAIL: channel %u pixel %u element %u shows %u, expected %u\n",
+                           c + 1, p, k, shown, expected);
+                    return failures + 1;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * FNV-1a over the bytes a strip showed last
+ */
+static uint32_t checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    std::vector<uint8_t> stream;
+    uint32_t frames = 1000;
+    if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+        frames = strtoul(argv[2], nullptr, 10);
+    } else if (argc == 2) {
+        if (!readFile(argv[1], stream)) {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 1;
+        }
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [capture.bin | -n frames]\n", argv[0]);
+        return 1;
+    }
+    bool generated = stream.empty();
+    if (generated) {
+        stream = generatePattern(frames);
+    }
+
+    DDPController controller(channelConfigs, numChannels);
+    controller.begin();
+
+    // Feed the link while running the Core 0 loop, as the board would
+    RxCounters rx;
+    ProcessCounters process;
+    uint32_t startUs = micros();
+    uint32_t elapsedUs = 0;
+    size_t fed = 0;
+    while (true) {
+        controller.getCounters(rx, process);
+        uint32_t inFlight = rx.packetsReceived - process.packetsProcessed - process.dropsParse - process.dropsStale;
+        if (fed < stream.size()) {
+            if (Serial.available() == 0 && inFlight < HOST_MAX_IN_FLIGHT) {
+                size_t n = min((size_t)HOST_WRITE_SIZE, stream.size() - fed);
+                Serial.inject(stream.data() + fed, n);
+                fed += n;
+            }
+        } else if (Serial.available() == 0 && inFlight == 0) {
+            elapsedUs = micros() - startUs;
+            break;
+        }
+        controller.update();
+    }
+    uint32_t drainStart = millis();
+    while (millis() - drainStart < HOST_DRAIN_MS) {
+        controller.update();
+    }
+
+    controller.end();
+
+    controller.getCounters(rx, process);
+    uint32_t shown, incomplete;
+    controller.getFrameStats(shown, incomplete);
+
+    printf("Input: %zu bytes in %.1f ms\n", stream.size(), elapsedUs / 1000.0);
+    printf("Packets: %u received, %u processed (%.0f/s)\n", rx.packetsReceived, process.packetsProcessed,
+           elapsedUs ? process.packetsProcessed * 1e6 / elapsedUs : 0.0);
+    printf("Drops: queue full %u, COBS %u, parse %u, stale %u\n",
+           rx.dropsQueueFull, rx.dropsCobs, process.dropsParse, process.dropsStale);
+    printf("Rejected: destination %u, range %u, config %u\n",
+           process.rejectedDest, process.rejectedRange, process.rejectedConfig);
+    printf("Frames: %u shown, %u channels incomplete\n", shown, incomplete);
+    for (uint8_t c = 0; c < numChannels; c++) {
+        const CaptureStrip* strip = CaptureStrip::find(channelConfigs[c].pin);
+        if (strip) {
+            printf("Channel %u (GP%u): %u shows, last frame %08x\n", c + 1, channelConfigs[c].pin,
+                   strip->getShowCount(), checksum(strip->getShown(), strip->getShownBytes()));
+        }
+    }
+
+    if (generated) {
+        uint32_t failures = verifyPattern(controller, frames);
+        printf("%s\n", failures ? "FAILED" : "PASSED");
+        return failures ? 1 : 0;
+    }
+    return 0;
+}
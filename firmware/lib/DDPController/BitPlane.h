@@ -0,0 +1,105 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bit-plane encoder for parallel LED output
+ * Turns up to 8 per-strip byte streams (lanes) into the GPIO words a single
+ * PIO state machine shifts out, one halfword per bit time: bit n of the
+ * halfword is the level of GPIO (basePin + n) for that bit.
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+class BitPlane {
+public:
+    // Output halfwords per lane byte (one per bit), packed two per word
+    static constexpr size_t WORDS_PER_BYTE = 4;
+
+    /**
+     * Transpose an 8x8 bit matrix
+     * @param in One byte per lane
+     * @param out One lane mask per bit, most significant bit first:
+     *            bit l of out[b] is bit (7 - b) of in[l]
+     */
+    static void transpose8(const uint8_t in[8], uint8_t out[8]) {
+        // Lanes are loaded in reverse so lane 0 lands in bit 0 of each mask
+        uint32_t x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+        uint32_t y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+        uint32_t t;
+
+        // Swap 1x1, 2x2 and 4x4 sub-blocks across the diagonal
+        t = (x ^ (x >> 7)) & 0x00AA00AA;
+        x = x ^ t ^ (t << 7);
+        t = (y ^ (y >> 7)) & 0x00AA00AA;
+        y = y ^ t ^ (t << 7);
+
+        t = (x ^ (x >> 14)) & 0x0000CCCC;
+        x = x ^ t ^ (t << 14);
+        t = (y ^ (y >> 14)) & 0x0000CCCC;
+        y = y ^ t ^ (t << 14);
+
+        t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+        y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+        x = t;
+
+        out[0] = x >> 24;
+        out[1] = x >> 16;
+        out[2] = x >> 8;
+        out[3] = x;
+        out[4] = y >> 24;
+        out[5] = y >> 16;
+        out[6] = y >> 8;
+        out[7] = y;
+    }
+
+    /**
+     * Build the lane mask to GPIO mask lookup table
+     * @param pins GPIO of each lane
+     * @param laneCount Number of lanes (max 8)
+     * @param basePin Lowest GPIO of the output window
+     * @param map Output table, 256 entries
+     */
+    static void buildPinMap(const uint8_t* pins, uint8_t laneCount, uint8_t basePin, uint16_t map[256]) {
+        for (uint16_t mask = 0; mask < 256; mask++) {
+            uint16_t gpio = 0;
+            for (uint8_t lane = 0; lane < laneCount && lane < 8; lane++) {
+                if (mask & (1 << lane)) {
+                    gpio |= 1 << (pins[lane] - basePin);
+                }
+            }
+            map[mask] = gpio;
+        }
+    }
+
+    /**
+     * Encode lanes into output words
+     * Lanes shorter than length are padded with zero bits.
+     * @param lanes Byte stream of each lane, in wire order
+     * @param lengths Length of each lane in bytes
+     * @param laneCount Number of lanes (max 8)
+     * @param length Bytes to encode per lane (the longest lane)
+     * @param map Lane mask to GPIO mask table from buildPinMap()
+     * @param out Output, length * WORDS_PER_BYTE words; the first bit of
+     *            each pair is in the low halfword
+     */
+    static void encode(const uint8_t* const lanes[], const size_t lengths[], uint8_t laneCount,
+                       size_t length, const uint16_t map[256], uint32_t* out) {
+        uint8_t in[8] = {0};
+        uint8_t masks[8];
+
+        for (size_t i = 0; i < length; i++) {
+            for (uint8_t lane = 0; lane < laneCount && lane < 8; lane++) {
+                in[lane] = (i < lengths[lane]) ? lanes[lane][i] : 0;
+            }
+
+            transpose8(in, masks);
+
+            out[0] = map[masks[0]] | ((uint32_t)map[masks[1]] << 16);
+            out[1] = map[masks[2]] | ((uint32_t)map[masks[3]] << 16);
+            out[2] = map[masks[4]] | ((uint32_t)map[masks[5]] << 16);
+            out[3] = map[masks[6]] | ((uint32_t)map[masks[7]] << 16);
+            out += WORDS_PER_BYTE;
+        }
+    }
+};
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Arduino.h>
+#include <Platform.h>
 
 /**
  * Dynamic Brightness Limiter
@@ -11,71 +11,68 @@
  * - Scales linearly between these points
  *
  * Uses efficient integer math with bit shifting for real-time performance.
+ *
+ * Works per frame: the owner reports how many lit LEDs each fragment adds
+ * or removes via adjustLitCount() as it lands, and reads one scale for the
+ * whole strip with getFrameScale() just before output.
  */
 class BrightnessLimiter {
 public:
     /**
      * Constructor
      * @param totalLEDs Total number of LEDs in the strip
-     * @param maxBrightness Maximum brightness scale (0-255, default 255 for 100%)
-     * @param minBrightness Minimum brightness scale (0-255, default 102 for ~40%)
+     * @param maxBrightness Maximum brightness scale (0-256, default 256 for 100%)
+     * @param minBrightness Minimum brightness scale (0-256, default 102 for ~40%)
      * @param threshold LED count threshold for max brightness (default 4)
      */
     BrightnessLimiter(uint16_t totalLEDs,
-                     uint8_t maxBrightness = 255,
-                     uint8_t minBrightness = 102,
+                     uint16_t maxBrightness = 256,
+                     uint16_t minBrightness = 102,
                      uint16_t threshold = 4)
         : totalLEDs(totalLEDs),
           maxScale(maxBrightness),
           minScale(minBrightness),
-          thresholdCount(threshold) {}
+          thresholdCount(threshold),
+          litCount(0) {}
 
     /**
-     * Apply brightness limiting to RGB pixel data
-     * @param rgbData Pointer to RGB data (3 bytes per pixel)
-     * @param pixelCount Number of pixels in the data
+     * Calculate brightness scale for a lit LED count
+     * @param lit Number of lit LEDs
+     * @return Scale to multiply components by (>> 8), 256 = unchanged
      */
-    void limitBrightness(uint8_t* rgbData, size_t pixelCount) {
-        // Count lit pixels (any RGB component > 0)
-        uint16_t litCount = 0;
-        for (size_t i = 0; i < pixelCount; ++i) {
-            uint8_t r = rgbData[i * 3];
-            uint8_t g = rgbData[i * 3 + 1];
-            uint8_t b = rgbData[i * 3 + 2];
-            if (r | g | b) {
-                ++litCount;
-            }
-        }
-
-        // Calculate brightness scale
-        uint8_t scale;
-        if (litCount <= thresholdCount) {
-            scale = maxScale;
-        } else if (litCount >= totalLEDs) {
-            scale = minScale;
-        } else {
-            // Linear interpolation: scale = max - ((lit - thresh) * (max - min)) / (total - thresh)
-            uint16_t range = totalLEDs - thresholdCount;
-            uint16_t diff = litCount - thresholdCount;
-            uint16_t scaleDiff = maxScale - minScale;
-            scale = maxScale - ((diff * scaleDiff) / range);
+    uint16_t computeScale(uint16_t lit) const {
+        if (lit <= thresholdCount) {
+            return maxScale;
+        } else if (lit >= totalLEDs) {
+            return minScale;
         }
+        // Linear interpolation: scale = max - ((lit - thresh) * (max - min)) / (total - thresh)
+        uint16_t range = totalLEDs - thresholdCount;
+        uint16_t diff = lit - thresholdCount;
+        uint16_t scaleDiff = maxScale - minScale;
+        return maxScale - ((diff * scaleDiff) / range);
+    }
 
-        // Apply scaling to each pixel 
-        for (size_t i = 0; i < pixelCount; ++i) {
-            uint8_t* r = &rgbData[i * 3];
-            uint8_t* g = &rgbData[i * 3 + 1];
-            uint8_t* b = &rgbData[i * 3 + 2];
+    /**
+     * Account for LEDs turned on or off by a frame fragment
+     * @param delta Newly lit LEDs minus newly dark LEDs
+     */
+    void adjustLitCount(int32_t delta) {
+        litCount += delta;
+    }
 
-            *r = (*r * scale) >> 8;
-            *g = (*g * scale) >> 8;
-            *b = (*b * scale) >> 8;
-        }
+    /**
+     * Get scale for the whole current frame
+     * @return Scale out of 256
+     */
+    uint16_t getFrameScale() const {
+        return computeScale(litCount);
     }
 
 private:
     uint16_t totalLEDs;
-    uint8_t maxScale;
-    uint8_t minScale;
+    uint16_t maxScale;
+    uint16_t minScale;
     uint16_t thresholdCount;
+    uint16_t litCount;
 };
\ No newline at end of file
@@ -1,84 +1,362 @@
 #pragma once
-#include <Arduino.h>
+#include <Platform.h>
 
 /**
  * COBS (Consistent Overhead Byte Stuffing) Decoder
  * Decodes COBS-encoded frames from serial stream
  * Frame format: [COBS encoded data] 0x00
+ *
+ * Two modes:
+ * - MODE_BUFFERED: encoded bytes are collected in frameBuffer and decoded
+ *   into decodeBuffer when the delimiter arrives (or into caller storage
+ *   via decodeFrame()).
+ * - MODE_STREAMING: bytes are decoded as they arrive, so the frame is ready
+ *   the moment its delimiter is seen. COBS output never outgrows its input,
+ *   so only one buffer is needed, and setOutput() can point the decoder at
+ *   caller storage (e.g. a packet queue slot) instead.
  */
 class COBSDecoder {
 public:
-    COBSDecoder(size_t maxFrameSize = 2048)
-        : maxFrameSize(maxFrameSize), framePos(0), decodedLength(0), state(STATE_WAITING) {
+    enum Mode {
+        MODE_BUFFERED,
+        MODE_STREAMING
+    };
+
+    COBSDecoder(size_t maxFrameSize = 2048, Mode mode = MODE_BUFFERED)
+        : maxFrameSize(maxFrameSize), framePos(0), decodedLength(0), state(STATE_WAITING),
+          mode(mode), blockRemaining(0), blockCode(0xFF), errors(0) {
         frameBuffer = new uint8_t[maxFrameSize];
-        decodeBuffer = new uint8_t[maxFrameSize];
+        decodeBuffer = (mode == MODE_BUFFERED) ? new uint8_t[maxFrameSize] : nullptr;
+        output = frameBuffer;
+        outputMax = maxFrameSize;
     }
-    
+
     ~COBSDecoder() {
         delete[] frameBuffer;
         delete[] decodeBuffer;
     }
-    
+
     /**
      * Process incoming byte
      * @param byte Input byte
      * @return true if complete frame decoded
      */
     bool processByte(uint8_t byte) {
+        if (receiveByte(byte)) {
+            if (mode == MODE_STREAMING) {
+                return true;
+            }
+            size_t decoded = decodeFrame(decodeBuffer, maxFrameSize);
+            if (decoded > 0) {
+                decodedLength = decoded;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Accumulate incoming byte
+     * In buffered mode the frame is left encoded so the caller can decode it
+     * straight into its own storage via decodeFrame(). In streaming mode it
+     * is already decoded into the current output.
+     * @param byte Input byte
+     * @return true if a delimiter completed a non-empty frame
+     */
+    bool receiveByte(uint8_t byte) {
         if (byte == 0x00) {
-            // Frame delimiter - decode if we have data
-            if (framePos > 0) {
-                size_t decoded = decode(frameBuffer, framePos, decodeBuffer, maxFrameSize);
-                if (decoded > 0) {
-                    decodedLength = decoded;
-                    framePos = 0;
-                    return true;
-                }
+            // Frame delimiter - frame is pending if we have data
+            return endFrame();
+        }
+
+        if (state == STATE_OVERFLOW) {
+            return false;
+        }
+        state = STATE_RECEIVING;
+
+        if (mode == MODE_STREAMING) {
+            if (blockRemaining == 0) {
+                startBlock(byte);
+            } else if (framePos < outputMax) {
+                output[framePos++] = byte;
+                blockRemaining--;
+            } else {
+                overflow();
             }
-            framePos = 0;
             return false;
         }
-        
+
         // Accumulate frame data
         if (framePos < maxFrameSize) {
             frameBuffer[framePos++] = byte;
         } else {
-            // Frame too large, reset
-            framePos = 0;
+            overflow();
         }
-        
+
         return false;
     }
-    
+
+    /**
+     * Process a block of incoming bytes
+     * Consumes input up to and including the first frame delimiter, so call
+     * again with the remaining bytes until the whole block is consumed.
+     * @param data Input bytes
+     * @param length Input length
+     * @param frameDecoded Set to true if a complete frame was decoded
+     * @return Number of bytes consumed
+     */
+    size_t processBlock(const uint8_t* data, size_t length, bool& frameDecoded) {
+        bool frameComplete;
+        size_t consumed = receiveBlock(data, length, frameComplete);
+
+        frameDecoded = false;
+        if (frameComplete) {
+            if (mode == MODE_STREAMING) {
+                frameDecoded = true;
+                return consumed;
+            }
+            size_t decoded = decodeFrame(decodeBuffer, maxFrameSize);
+            if (decoded > 0) {
+                decodedLength = decoded;
+                frameDecoded = true;
+            }
+        }
+        return consumed;
+    }
+
+    /**
+     * Accumulate a block of incoming bytes
+     * Scans for the delimiter a word at a time and moves the run before it
+     * with memcpy: appended as-is in buffered mode, decoded block by block
+     * in streaming mode. Consumes input up to and including the first
+     * frame delimiter.
+     * @param data Input bytes
+     * @param length Input length
+     * @param frameComplete Set to true if a delimiter completed a non-empty
+     *                      frame; in buffered mode call decodeFrame() before
+     *                      feeding more data
+     * @return Number of bytes consumed
+     */
+    size_t receiveBlock(const uint8_t* data, size_t length, bool& frameComplete) {
+        size_t run = findDelimiter(data, length);
+
+        if (state != STATE_OVERFLOW && run > 0) {
+            state = STATE_RECEIVING;
+            if (mode == MODE_STREAMING) {
+                streamRun(data, run);
+            } else if (run <= maxFrameSize - framePos) {
+                memcpy(frameBuffer + framePos, data, run);
+                framePos += run;
+            } else {
+                overflow();
+            }
+        }
+
+        if (run == length) {
+            frameComplete = false;
+            return length;  // No delimiter in this block
+        }
+
+        frameComplete = endFrame();
+        return run + 1;
+    }
+
+    /**
+     * Set where streaming mode decodes the next frame
+     * Only call between frames (right after a completed frame or while
+     * isIdle()); nullptr restores the decoder's own buffer.
+     * @param buffer Output storage
+     * @param capacity Output capacity; longer frames are dropped
+     */
+    void setOutput(uint8_t* buffer, size_t capacity) {
+        if (buffer) {
+            output = buffer;
+            outputMax = capacity;
+        } else {
+            output = frameBuffer;
+            outputMax = maxFrameSize;
+        }
+    }
+
+    /**
+     * Check if no frame is in progress
+     */
+    bool isIdle() const {
+        return state == STATE_WAITING;
+    }
+
+    /**
+     * Decode the pending frame into caller storage and start the next one (buffered mode)
+     * @param output Output buffer
+     * @param outputMax Maximum output size
+     * @return Decoded length, 0 on error
+     */
+    size_t decodeFrame(uint8_t* output, size_t outputMax) {
+        size_t decoded = decode(frameBuffer, framePos, output, outputMax);
+        framePos = 0;
+        if (decoded == 0) {
+            errors++;
+        }
+        return decoded;
+    }
+
     /**
      * Get decoded frame data
      */
     const uint8_t* getFrame() const {
-        return decodeBuffer;
+        return (mode == MODE_STREAMING) ? output : decodeBuffer;
     }
-    
+
     /**
      * Get decoded frame length
      */
     size_t getFrameLength() const {
         return decodedLength;
     }
-    
+
+    /**
+     * Get the number of frames dropped as malformed
+     * Counts frames longer than the output, frames cut short by a delimiter
+     * inside a block and, in buffered mode, frames that failed to decode.
+     * Never reset; read it from the core that feeds the decoder.
+     */
+    uint32_t getErrorCount() const {
+        return errors;
+    }
+
     /**
      * Reset decoder state
      */
     void reset() {
         framePos = 0;
         decodedLength = 0;
+        blockRemaining = 0;
+        blockCode = 0xFF;
         state = STATE_WAITING;
     }
 
 private:
     enum State {
         STATE_WAITING,
-        STATE_RECEIVING
+        STATE_RECEIVING,
+        STATE_OVERFLOW
     };
-    
+
+    /**
+     * Handle a frame delimiter
+     * @return true if a non-empty frame is pending decode (buffered) or
+     *         fully decoded (streaming)
+     */
+    bool endFrame() {
+        bool pending = state == STATE_RECEIVING && framePos > 0;
+
+        if (mode == MODE_STREAMING) {
+            // A delimiter inside a block means the frame was truncated
+            if (pending && blockRemaining != 0) {
+                errors++;
+                pending = false;
+            }
+            if (pending) {
+                decodedLength = framePos;
+            }
+            framePos = 0;
+            blockRemaining = 0;
+            blockCode = 0xFF;
+        } else if (!pending) {
+            framePos = 0;
+        }
+
+        state = STATE_WAITING;
+        return pending;
+    }
+
+    /**
+     * Drop the current frame up to the next delimiter
+     */
+    void overflow() {
+        if (state != STATE_OVERFLOW) {
+            errors++;
+        }
+        framePos = 0;
+        state = STATE_OVERFLOW;
+    }
+
+    /**
+     * Start a COBS block in streaming mode
+     * The zero implied by the previous block is only emitted once another
+     * block proves the frame continues.
+     */
+    void startBlock(uint8_t code) {
+        if (blockCode < 0xFF) {
+            if (framePos >= outputMax) {
+                overflow();
+                return;
+            }
+            output[framePos++] = 0;
+        }
+        blockCode = code;
+        blockRemaining = code - 1;
+    }
+
+    /**
+     * Decode a delimiter-free run in streaming mode
+     */
+    void streamRun(const uint8_t* data, size_t length) {
+        size_t i = 0;
+        while (i < length) {
+            if (blockRemaining == 0) {
+                startBlock(data[i++]);
+                if (state == STATE_OVERFLOW) {
+                    return;
+                }
+                continue;
+            }
+
+            size_t n = min(blockRemaining, length - i);
+            if (n > outputMax - framePos) {
+                overflow();
+                return;
+            }
+            memcpy(output + framePos, data + i, n);
+            framePos += n;
+            blockRemaining -= n;
+            i += n;
+        }
+    }
+
+    /**
+     * Find the first 0x00 delimiter
+     * Checks four bytes per step once the pointer is word aligned.
+     * @return Index of the delimiter, or length if there is none
+     */
+    static size_t findDelimiter(const uint8_t* data, size_t length) {
+        size_t i = 0;
+
+        // Byte steps up to word alignment
+        while (i < length && ((uintptr_t)(data + i) & 3)) {
+            if (data[i] == 0x00) {
+                return i;
+            }
+            i++;
+        }
+
+        // Word steps: (v - 0x01..) & ~v & 0x80.. is non-zero iff v has a zero byte
+        while (i + 4 <= length) {
+            uint32_t v;
+            memcpy(&v, data + i, 4);
+            if ((v - 0x01010101u) & ~v & 0x80808080u) {
+                break;
+            }
+            i += 4;
+        }
+
+        // Locate the zero inside the word, or finish the tail
+        while (i < length && data[i] != 0x00) {
+            i++;
+        }
+        return i;
+    }
+
     /**
      * COBS decode implementation
      * @param input Encoded data
@@ -91,25 +369,29 @@ private:
         if (inputLen == 0) {
             return 0;
         }
-        
+
         size_t inPos = 0;
         size_t outPos = 0;
-        
+
         while (inPos < inputLen) {
             uint8_t code = input[inPos++];
-            
+
             if (code == 0) {
                 break;  // End of frame
             }
-            
-            // Copy (code - 1) bytes
-            for (uint8_t i = 1; i < code && inPos < inputLen; i++) {
-                if (outPos >= outputMax) {
-                    return 0;  // Output buffer overflow
-                }
-                output[outPos++] = input[inPos++];
+
+            // Copy (code - 1) bytes as one run
+            size_t run = code - 1;
+            if (run > inputLen - inPos) {
+                return 0;  // Truncated block
+            }
+            if (run > outputMax - outPos) {
+                return 0;  // Output buffer overflow
             }
-            
+            memcpy(output + outPos, input + inPos, run);
+            inPos += run;
+            outPos += run;
+
             // Add zero byte if not at end and code < 0xFF
             if (code < 0xFF && inPos < inputLen) {
                 if (outPos >= outputMax) {
@@ -118,14 +400,24 @@ private:
                 output[outPos++] = 0;
             }
         }
-        
+
         return outPos;
     }
-    
+
     uint8_t* frameBuffer;
     uint8_t* decodeBuffer;
     size_t maxFrameSize;
     size_t framePos;
     size_t decodedLength;
     State state;
+    Mode mode;
+
+    // Streaming mode: where decoded bytes go and how much of the current
+    // COBS block is still to come
+    uint8_t* output;
+    size_t outputMax;
+    size_t blockRemaining;
+    uint8_t blockCode;
+
+    uint32_t errors;  // Malformed frames dropped
 };
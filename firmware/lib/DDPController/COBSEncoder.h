@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * COBS (Consistent Overhead Byte Stuffing) Encoder
+ * Counterpart of COBSDecoder for frames sent back to the host.
+ * Frame format on the wire: 0x00 [COBS encoded data] 0x00
+ * The leading delimiter ends any partial text line the host is parsing,
+ * so binary frames can share the serial link with log output.
+ */
+class COBSEncoder {
+public:
+    /**
+     * Worst-case encoded size, delimiters excluded
+     * @param length Input length
+     */
+    static constexpr size_t maxEncodedLength(size_t length) {
+        return length + length / 254 + 1;
+    }
+
+    /**
+     * Encode a frame
+     * @param data Input bytes
+     * @param length Input length
+     * @param out Output, at least maxEncodedLength(length) bytes
+     * @return Encoded length (no delimiters)
+     */
+    static size_t encode(const uint8_t* data, size_t length, uint8_t* out) {
+        size_t codePos = 0;
+        size_t outPos = 1;
+        uint8_t code = 1;
+
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] == 0) {
+                out[codePos] = code;
+                codePos = outPos++;
+                code = 1;
+                continue;
+            }
+            out[outPos++] = data[i];
+            if (++code == 0xFF) {
+                out[codePos] = code;
+                codePos = outPos++;
+                code = 1;
+            }
+        }
+        out[codePos] = code;
+        return outPos;
+    }
+};
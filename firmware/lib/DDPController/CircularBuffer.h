@@ -1,17 +1,57 @@
 #pragma once
-#include <Arduino.h>
-#include <pico/mutex.h>
+#include <Platform.h>
 
 /**
  * Thread-safe Circular Buffer for dual-core communication
  * Core 0 writes incoming DDP packets
  * Core 1 reads and processes packets
+ *
+ * Records wrap around the buffer edge, so the claim/commit/peek/release
+ * API is served through private staging buffers of STAGING_SIZE bytes.
  */
-template<size_t BUFFER_SIZE>
+template<size_t BUFFER_SIZE, size_t STAGING_SIZE = 2048>
 class CircularBuffer {
 public:
-    CircularBuffer() : writeIndex(0), readIndex(0), count(0) {
-        mutex_init(&bufferMutex);
+    // Largest record a single claim can hold
+    static constexpr size_t MAX_RECORD_SIZE = STAGING_SIZE;
+
+    CircularBuffer() : writeIndex(0), readIndex(0), count(0) {}
+
+    /**
+     * Reserve space for a record (writer side)
+     * @param length Maximum payload length that will be written
+     * @return Pointer to staging storage, nullptr if buffer full
+     */
+    uint8_t* claim(size_t length) {
+        if (length == 0 || length > STAGING_SIZE || availableSpace() < length + 2) {
+            return nullptr;
+        }
+        return claimStaging;
+    }
+
+    /**
+     * Copy the claimed record into the buffer (writer side)
+     * @param length Bytes actually written, at most the claimed length
+     */
+    void commit(size_t length) {
+        write(claimStaging, length);
+    }
+
+    /**
+     * Read the oldest record into staging storage (reader side)
+     * @param length Output payload length
+     * @return Pointer to payload, nullptr if empty
+     */
+    const uint8_t* peek(size_t& length) {
+        length = read(peekStaging, STAGING_SIZE);
+        return length ? peekStaging : nullptr;
+    }
+
+    /**
+     * Free the record returned by the last peek() (reader side)
+     */
+    void release() {
+        // Already removed from the buffer by peek()
     }
     
     /**
@@ -25,12 +65,12 @@ public:
             return false;
         }
         
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         
         // Check if we have space (need length + 2 bytes for size header)
         size_t required = length + 2;
         if (count + required > BUFFER_SIZE) {
-            mutex_exit(&bufferMutex);
+            bufferMutex.unlock();
             return false;  // Buffer full
         }
         
@@ -48,7 +88,7 @@ public:
         
         count += required;
         
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
         return true;
     }
     
@@ -59,11 +99,11 @@ public:
      * @return Number of bytes read, 0 if empty
      */
     size_t read(uint8_t* data, size_t maxLength) {
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         
         // Check if we have data
         if (count < 2) {
-            mutex_exit(&bufferMutex);
+            bufferMutex.unlock();
             return 0;  // Empty
         }
         
@@ -80,7 +120,7 @@ public:
             // Corrupted data, reset buffer
             readIndex = writeIndex;
             count = 0;
-            mutex_exit(&bufferMutex);
+            bufferMutex.unlock();
             return 0;
         }
         
@@ -92,7 +132,7 @@ public:
         
         count -= (length + 2);
         
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
         return length;
     }
     
@@ -100,9 +140,9 @@ public:
      * Check if buffer has data available
      */
     bool available() {
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         bool hasData = count >= 2;
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
         return hasData;
     }
     
@@ -110,9 +150,9 @@ public:
      * Get available space in buffer
      */
     size_t availableSpace() {
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         size_t space = BUFFER_SIZE - count;
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
         return space;
     }
     
@@ -120,27 +160,29 @@ public:
      * Clear buffer
      */
     void clear() {
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         readIndex = 0;
         writeIndex = 0;
         count = 0;
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
     }
     
     /**
      * Get buffer usage statistics
      */
     float getUsagePercent() {
-        mutex_enter_blocking(&bufferMutex);
+        bufferMutex.lock();
         float usage = (count * 100.0f) / BUFFER_SIZE;
-        mutex_exit(&bufferMutex);
+        bufferMutex.unlock();
         return usage;
     }
 
 private:
     uint8_t buffer[BUFFER_SIZE];
+    uint8_t claimStaging[STAGING_SIZE];
+    uint8_t peekStaging[STAGING_SIZE];
     volatile size_t writeIndex;
     volatile size_t readIndex;
     volatile size_t count;
-    mutex_t bufferMutex;
+    PlatformMutex bufferMutex;
 };
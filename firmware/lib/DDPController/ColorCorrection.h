@@ -0,0 +1,132 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Build-time color correction defaults: gamma and per-primary white point
+// (255 = full). The default is identity, so hosts that correct color
+// themselves see no change.
+#ifndef DDP_GAMMA
+#define DDP_GAMMA 1.0
+#endif
+
+#ifndef DDP_WHITE_POINT_R
+#define DDP_WHITE_POINT_R 255
+#endif
+#ifndef DDP_WHITE_POINT_G
+#define DDP_WHITE_POINT_G 255
+#endif
+#ifndef DDP_WHITE_POINT_B
+#define DDP_WHITE_POINT_B 255
+#endif
+#ifndef DDP_WHITE_POINT_W
+#define DDP_WHITE_POINT_W 255
+#endif
+
+/**
+ * Color correction lookup tables
+ * One 256-entry table per element (R, G, B, W), applied while DDP data is
+ * converted into a channel frame, so correction costs one load per element
+ * and no extra pass. Entries are 8.8 fixed point output levels (255.0 =
+ * 0xFF00), so dark gamma-corrected levels keep their fraction for the
+ * temporal dither instead of being rounded away.
+ */
+struct ColorLUT {
+    uint16_t table[4][256];
+};
+
+/**
+ * Compile-time generation of color correction tables
+ * pow() is not constexpr, so it is built from range-reduced log and exp
+ * series; accurate to well under one 8-bit step.
+ */
+class ColorCorrection {
+public:
+    /**
+     * Build tables for a gamma curve and white point
+     * entry = round(256 * white * (i / 255) ^ gamma)
+     * @param gamma Gamma exponent (1.0 = linear)
+     * @param r Red white point (0-255)
+     * @param g Green white point (0-255)
+     * @param b Blue white point (0-255)
+     * @param w White white point (0-255)
+     */
+    static constexpr ColorLUT make(double gamma, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+        ColorLUT lut = {};
+        const uint8_t white[4] = {r, g, b, w};
+        for (int i = 0; i < 256; i++) {
+            double level = power(i / 255.0, gamma);
+            for (int e = 0; e < 4; e++) {
+                lut.table[e][i] = (uint16_t)(level * white[e] * 256 + 0.5);
+            }
+        }
+        return lut;
+    }
+
+    /**
+     * Get the build-time default tables (DDP_GAMMA, DDP_WHITE_POINT_*)
+     */
+    static const ColorLUT& defaults();
+
+private:
+    static constexpr double LN2 = 0.69314718055994530942;
+
+    /**
+     * x ^ y for x in [0, 1], y > 0
+     */
+    static constexpr double power(double x, double y) {
+        if (x <= 0.0) {
+            return 0.0;
+        }
+        return exponent(y * logarithm(x));
+    }
+
+    /**
+     * Natural log for x in (0, 1]
+     */
+    static constexpr double logarithm(double x) {
+        // x = m * 2^-k with m in [0.5, 1]
+        int k = 0;
+        while (x < 0.5) {
+            x *= 2.0;
+            k++;
+        }
+        // ln(m) = 2 * atanh(z), z = (m - 1) / (m + 1), |z| <= 1/3
+        double z = (x - 1.0) / (x + 1.0);
+        double z2 = z * z;
+        double term = z;
+        double sum = 0.0;
+        for (int n = 1; n < 40; n += 2) {
+            sum += term / n;
+            term *= z2;
+        }
+        return 2.0 * sum - k * LN2;
+    }
+
+    /**
+     * e ^ x for x <= 0
+     */
+    static constexpr double exponent(double x) {
+        // e^x = (e^(x / 2^k))^(2^k) with |x / 2^k| <= 0.5
+        int k = 0;
+        while (x < -0.5) {
+            x /= 2.0;
+            k++;
+        }
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 20; n++) {
+            term *= x / n;
+            sum += term;
+        }
+        for (int i = 0; i < k; i++) {
+            sum *= sum;
+        }
+        return sum;
+    }
+};
+
+inline const ColorLUT& ColorCorrection::defaults() {
+    static constexpr ColorLUT lut = make(DDP_GAMMA, DDP_WHITE_POINT_R, DDP_WHITE_POINT_G,
+                                         DDP_WHITE_POINT_B, DDP_WHITE_POINT_W);
+    return lut;
+}
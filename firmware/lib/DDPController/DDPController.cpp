@@ -2,3 +2,6 @@
 
 // Global instance pointer definition
 DDPController* g_ddpController = nullptr;
+
+// Runtime log level, starts at the compile-time ceiling
+uint8_t g_ddpLogLevel = DDP_LOG_LEVEL;
@@ -1,15 +1,146 @@
 #pragma once
-#include <Arduino.h>
+#include <Platform.h>
 #include <Orb.h>
+#include <atomic>
 #include "DDPProtocol.h"
 #include "CircularBuffer.h"
+#include "SPSCQueue.h"
+#include "PacketPool.h"
 #include "COBSDecoder.h"
+#include "COBSEncoder.h"
+#include "Telemetry.h"
+#include "Profile.h"
 #include "BrightnessLimiter.h"
-#include <pico/multicore.h>
+#include "RxSource.h"
+#include "DDPLog.h"
+#include "ParallelOutput.h"
+#include "PixelConvert.h"
+#include "SequenceTracker.h"
+#include "DirtyBitmap.h"
+#include "PresentationClock.h"
+#include "StatsCounters.h"
 
-// Buffer size: 64KB for circular buffer (can hold ~40 full DDP packets)
+// Inter-core packet queue selection
+#define DDP_QUEUE_POOL  0  // Fixed-slot packet pool (default)
+#define DDP_QUEUE_RING  1  // Lock-free length-prefixed byte ring
+#define DDP_QUEUE_MUTEX 2  // Mutex-guarded CircularBuffer
+
+#ifndef DDP_PACKET_QUEUE
+#define DDP_PACKET_QUEUE DDP_QUEUE_POOL
+#endif
+
+// Packet pool: 32 slots of one full DDP packet each (~46KB)
+#define DDP_PACKET_POOL_SLOTS 32
+
+// Byte ring size: 64KB (can hold ~40 full DDP packets)
 #define DDP_CIRCULAR_BUFFER_SIZE (64 * 1024)
 
+#if DDP_PACKET_QUEUE == DDP_QUEUE_MUTEX
+typedef CircularBuffer<DDP_CIRCULAR_BUFFER_SIZE> DDPPacketQueue;
+#elif DDP_PACKET_QUEUE == DDP_QUEUE_RING
+typedef SPSCQueue<DDP_CIRCULAR_BUFFER_SIZE> DDPPacketQueue;
+#else
+typedef PacketPool<DDP_PACKET_POOL_SLOTS> DDPPacketQueue;
+#endif
+
+// Receive backend selection
+#define DDP_RX_SERIAL   0  // Bulk reads from USB CDC Serial (default)
+#define DDP_RX_UART_DMA 1  // Hardware UART RX into double-buffered DMA blocks
+
+#ifndef DDP_RX_BACKEND
+#define DDP_RX_BACKEND DDP_RX_SERIAL
+#endif
+
+// Serial bytes pulled per read on Core 1
+#define DDP_RX_BLOCK_SIZE 512
+
+// UART DMA backend: port, RX pin, baud rate and size of each DMA block
+#define DDP_RX_UART uart0
+#define DDP_RX_UART_PIN 1
+#define DDP_RX_UART_BAUD 921600
+#define DDP_RX_DMA_BLOCK_SIZE 256
+
+#if DDP_RX_BACKEND == DDP_RX_UART_DMA
+typedef UartDmaRxSource<DDP_RX_DMA_BLOCK_SIZE> DDPRxSource;
+#else
+typedef StreamRxSource<DDP_RX_BLOCK_SIZE> DDPRxSource;
+#endif
+
+// Largest COBS frame accepted from the serial link (decoded size)
+#define DDP_COBS_MAX_FRAME_SIZE 2048
+
+// Deferred log records queued per core before the output core drains them
+#define DDP_LOG_RING_SIZE 32
+
+// Free USB transmit space required before a deferred record is written
+#define DDP_LOG_DRAIN_MIN_SPACE 96
+
+// LED output engine selection
+#define DDP_OUTPUT_SEQUENTIAL 0  // Each Orb shows its own strip in turn
+#define DDP_OUTPUT_PARALLEL   1  // All strips at once from one PIO state machine fed by DMA
+
+#ifndef DDP_OUTPUT_ENGINE
+#if defined(ARDUINO_ARCH_RP2040)
+#define DDP_OUTPUT_ENGINE DDP_OUTPUT_PARALLEL
+#else
+#define DDP_OUTPUT_ENGINE DDP_OUTPUT_SEQUENTIAL
+#endif
+#endif
+
+// Refresh rate of the temporal dither; strips are re-sent this often
+// between pushes so the dither can average out fractional levels.
+// 0 outputs on push only.
+#ifndef DDP_REFRESH_HZ
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+#define DDP_REFRESH_HZ 200
+#else
+#define DDP_REFRESH_HZ 0
+#endif
+#endif
+
+// DDP address mapping
+#define DDP_MAPPING_PER_CHANNEL 0  // Destination ID N is channel N, offsets within that strip (default)
+#define DDP_MAPPING_GLOBAL      1  // Destination ID 1 spans all channels back to back, in channelConfigs order
+
+#ifndef DDP_MAPPING_MODE
+#define DDP_MAPPING_MODE DDP_MAPPING_PER_CHANNEL
+#endif
+
+// Drop fragments that arrive after the frame they belong to has been pushed
+// (see SequenceTracker.h). Off by default: late fragments are applied.
+#ifndef DDP_DROP_STALE
+#define DDP_DROP_STALE 0
+#endif
+
+// Longest time a push waits for the other channels of its frame. Pushes
+// are collected until every channel pushed in the previous frame has pushed
+// again, then all changed channels go out together; a channel that stops
+// pushing delays output by at most this long once. 0 outputs on every push.
+#ifndef DDP_PUSH_HOLD_US
+#define DDP_PUSH_HOLD_US 5000
+#endif
+
+// Scheduled presentation: a frame pushed with a timecode is committed to
+// the front buffers and held there until the host clock
+// (DDP_CONFIG_TIME_SYNC) reaches it, while packets of the next frame keep
+// being applied. Should the next frame complete before the held one is
+// shown, its successors back up in the packet queue, so the maximum lead is
+// what one frame plus the queue absorb at typical frame rates. Timecodes
+// further ahead are shown straight away; frames shown more than
+// DDP_PRESENT_LATE_US after their timecode are counted as late.
+#ifndef DDP_PRESENT_MAX_LEAD_US
+#define DDP_PRESENT_MAX_LEAD_US 100000
+#endif
+#ifndef DDP_PRESENT_LATE_US
+#define DDP_PRESENT_LATE_US 2000
+#endif
+
+// Binary telemetry record (Telemetry.h) interval; replaces the periodic ACK
+// and stats text lines. 0 goes back to the text lines.
+#ifndef DDP_TELEMETRY_INTERVAL_MS
+#define DDP_TELEMETRY_INTERVAL_MS 1000
+#endif
+
 // Maximum number of LED channels supported
 // RP2040 provides 8 PIO state machines (4 per PIO block), so we allow up to 8
 // concurrent LED outputs when the Orb driver is configured accordingly.
@@ -19,8 +150,18 @@
 struct LEDChannel {
     uint16_t numLEDs;
     uint8_t pin;
-    Orb* orb;
-    BrightnessLimiter* limiter;
+    neoPixelType format = ORB_PIXEL_TYPE;  // NEO_* color order plus speed
+
+    // Created by DDPController
+    Orb* orb = nullptr;
+    BrightnessLimiter* limiter = nullptr;
+    uint16_t* frame = nullptr;  // Back buffer: unscaled 8.8 levels assembled from DDP fragments, RGB or RGBW like the strip
+    uint16_t* front = nullptr;  // Front buffer: last pushed frame, re-sent on every refresh
+    uint8_t* residual = nullptr;  // Temporal dither state, one byte per front element
+    uint16_t frontScale = 256;  // Brightness scale taken when the front buffer was pushed
+    ColorLUT* lut = nullptr;    // Color correction applied as fragments land
+    uint8_t lutClass = 0;       // Channels with the same class have identical tables
+    DirtyBitmap dirty{};        // Pixels written since the last push
 };
 
 // Forward declaration
@@ -41,20 +182,69 @@ extern DDPController* g_ddpController;
 class DDPController {
 public:
     DDPController(const LEDChannel* channelConfigs, uint8_t numChannels)
-        : decoder(2048),
+        : numChannels(numChannels),
+          decoder(RX_SLOT_SIZE, COBSDecoder::MODE_STREAMING),
+          rxSlot(nullptr),
+#if DDP_RX_BACKEND == DDP_RX_UART_DMA
+          defaultRxSource(DDP_RX_UART, DDP_RX_UART_PIN, DDP_RX_UART_BAUD),
+#else
+          defaultRxSource(Serial),
+#endif
+          rxSource(&defaultRxSource),
           running(false),
-          packetsReceived(0),
-          packetsProcessed(0),
-          packetsDropped(0),
+          telemetryIntervalMs(DDP_TELEMETRY_INTERVAL_MS),
+          lastTelemetryTime(0),
           lastStatsTime(0),
-          numChannels(numChannels) {
+          framesShown(0),
+          renderMicros(0),
+          rateStartMs(0),
+          rateStartFrames(0),
+          frameRateX10(0),
+          framesIncomplete(0),
+          pushedMask(0),
+          expectedMask(0),
+          pushSinceUs(0),
+          packetCompletedAt(0),
+          packetQueuedAt(0),
+          packetReadAt(0),
+          pushCompletedAt(0),
+          pushAppliedAt(0),
+          framePushCompletedAt(0),
+          profileNextStage(Profiler::STAGE_COUNT),
+          presentPending(false),
+          presentTimecode(0),
+          presentHeld(false),
+          frameTimed(false),
+          frameTimecode(0),
+          frameMask(0),
+          framesScheduled(0),
+          framesLate(0),
+          framesBackedUp(0),
+          mappingMode(DDP_MAPPING_MODE),
+          totalLEDs(0),
+#if DDP_REFRESH_HZ
+          refreshPeriodUs(1000000 / DDP_REFRESH_HZ),
+#else
+          refreshPeriodUs(0),
+#endif
+          lastRefreshUs(0) {
         g_ddpController = this;
 
         // Initialize channels
         for (uint8_t i = 0; i < numChannels && i < MAX_LED_CHANNELS; i++) {
             channels[i] = channelConfigs[i];
-            channels[i].orb = new Orb(ORB_PRESET_PICO, channelConfigs[i].numLEDs, channelConfigs[i].pin);
+            channels[i].orb = Orb::create(channelConfigs[i].numLEDs, channelConfigs[i].pin, channelConfigs[i].format);
             channels[i].limiter = new BrightnessLimiter(channelConfigs[i].numLEDs);
+            size_t elements = channels[i].orb->getPixelBytes();
+            channels[i].frame = new uint16_t[elements]();
+            channels[i].front = new uint16_t[elements]();
+            channels[i].residual = new uint8_t[elements]();
+            channels[i].lut = new ColorLUT(ColorCorrection::defaults());
+            channels[i].dirty.allocate(channelConfigs[i].numLEDs);
+            
+            // Span table for the global offset space
+            channelStart[i] = totalLEDs;
+            totalLEDs += channels[i].numLEDs;
         }
     }
     
@@ -79,19 +269,36 @@ public:
             }
         }
 
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        // Take the strip pins over for parallel output; falls back to the
+        // Orbs' own show() if the pins do not fit one PIO window
+        uint8_t lanePins[MAX_LED_CHANNELS];
+        size_t maxBytes = 0;
+        for (uint8_t i = 0; i < numChannels; i++) {
+            lanePins[i] = channels[i].pin;
+            maxBytes = max(maxBytes, channels[i].orb->getPixelBytes());
+        }
+        if (parallelOutput.begin(lanePins, numChannels, maxBytes)) {
+            DDP_LOGI("[Info] Parallel output on %u channels", numChannels);
+        } else {
+            DDP_LOGW("[Warn] Parallel output unavailable, showing channels one at a time");
+            // Sequential refreshes would block packet processing
+            refreshPeriodUs = 0;
+        }
+#endif
+
         // Clear buffer
         buffer.clear();
 
-        // Reset stats
-        packetsReceived = 0;
-        packetsProcessed = 0;
-        packetsDropped = 0;
+        // Reset stats; Core 1 owns its block but has not started yet
+        rxStats.reset();
+        processStats.reset();
         lastStatsTime = millis();
 
         running = true;
 
         // Launch Core 1 for serial reception
-        multicore_launch_core1(core1Entry);
+        platformLaunchCore1(core1Entry);
 
         Serial.println("[DDPico] [Info] DDP Controller initialized");
         Serial.println("[DDPico] [Info] Core 1: Serial receiver active");
@@ -103,7 +310,7 @@ public:
      */
     void end() {
         running = false;
-        multicore_reset_core1();
+        platformStopCore1();
         Serial.println("[DDPico] [Info] DDP Controller stopped");
     }
     
@@ -112,84 +319,144 @@ public:
      * Processes packets from circular buffer and updates LEDs
      */
     void update() {
-         // Check if we have data in buffer
-         if (!buffer.available()) {
-             return;
+         // Re-send the front buffers on schedule, independent of pushes;
+         // not while they hold a frame that is not due yet
+         if (refreshPeriodUs && !presentHeld && micros() - lastRefreshUs >= refreshPeriodUs && !outputBusy()) {
+             refresh();
          }
          
-         // Read packet from buffer
-         uint8_t packetData[2048];
-         size_t packetLen = buffer.read(packetData, sizeof(packetData));
-         
-         if (packetLen == 0) {
-             return;
+         // A committed frame waits in the front buffers for its presentation
+         // time while packets of the next one are applied to the back buffers
+         if (presentHeld && presentationDue(frameTimecode)) {
+             presentFrame();
          }
          
-         // Parse DDP packet
-         DDPPacket packet;
-         if (!DDPProtocol::parsePacket(packetData, packetLen, packet)) {
-             packetsDropped++;
-             
-             // Log detailed parse failure info with RAW HEX dump
-             if (packetsDropped <= 5) {
-                 Serial.print("[DDPico] ERROR: Parse failed - Len: ");
-                 Serial.print(packetLen);
-                 if (packetLen >= 12) {
-                     Serial.print(", Flags: 0x");
-                     Serial.print(packetData[0], HEX);
-                     Serial.print(", Seq: ");
-                     Serial.print(packetData[1]);
-                     Serial.print(", Type: 0x");
-                     Serial.print(packetData[2], HEX);
-                     Serial.print(", Dest: ");
-                     Serial.print(packetData[3]);
-                     Serial.print(", Offset: ");
-                     Serial.print(((uint16_t)packetData[8] << 8) | packetData[9]);
-                     Serial.print(", DataLen: ");
-                     Serial.print(((uint16_t)packetData[10] << 8) | packetData[11]);
-                     
-                     // Show first 16 bytes in hex
-                     Serial.print("\n[DDPico] RAW HEX: ");
-                     for (int i = 0; i < min(16, (int)packetLen); i++) {
-                         if (packetData[i] < 0x10) Serial.print("0");
-                         Serial.print(packetData[i], HEX);
-                         Serial.print(" ");
-                     }
-                 }
-                 Serial.println();
+         // A complete frame is committed once the front buffers are free;
+         // until then the packets after it stay queued
+         if (framePushReady()) {
+             if (presentHeld) {
+                 idle();
+                 return;
+             }
+             commitFrame();
+             if (!presentHeld) {
+                 presentFrame();
              }
-             return;
          }
          
-         packetsProcessed++;
+         // Borrow the next packet from the buffer; it is parsed and applied
+         // in place and handed back once processed
+         size_t packetLen;
+         const uint8_t* packetData = buffer.available() ? buffer.peek(packetLen) : nullptr;
          
-         // Log ALL processed packets for debugging
-         Serial.print("[DDPico] ✓ Processing packet #");
-         Serial.print(packetsProcessed);
-         Serial.print(" - Offset: ");
-         Serial.print(packet.dataOffset);
-         Serial.print(", Length: ");
-         Serial.print(packet.dataLength);
-         Serial.print(", Push: ");
-         Serial.println(packet.shouldPush() ? "YES" : "NO");
-         
-         // Apply pixel data to LEDs (includes conditional pixelsShow when PUSH flag set)
-         applyPixelData(packet);
-         
-         // Print stats periodically
-         if (millis() - lastStatsTime >= 5000) {
-             printStats();
-             lastStatsTime = millis();
+         if (!packetData) {
+             // Nothing to output, spend the time on logging instead
+             idle();
+             return;
          }
+         
+#if DDP_PACKET_QUEUE == DDP_QUEUE_POOL
+         buffer.peekTimes(packetCompletedAt, packetQueuedAt);
+#endif
+         packetReadAt = DDP_PROFILE_NOW();
+         processPacket(packetData, packetLen);
+         buffer.release();
+    }
+    
+    /**
+     * Set runtime log level
+     * Levels above DDP_LOG_LEVEL are compiled out and cannot be enabled here.
+     * @param level DDP_LOG_NONE .. DDP_LOG_DEBUG
+     */
+    void setLogLevel(uint8_t level) {
+        g_ddpLogLevel = level;
+    }
+    
+    /**
+     * Get sequence number statistics (gaps, duplicates, late and stale packets)
+     * Call from Core 0.
+     */
+    const SequenceTracker::Stats& getSequenceStats() const {
+        return sequence.getStats();
+    }
+    
+    /**
+     * Set the telemetry interval
+     * @param intervalMs Milliseconds between telemetry records, 0 for text stats instead
+     */
+    void setTelemetryInterval(uint32_t intervalMs) {
+        telemetryIntervalMs = intervalMs;
+    }
+    
+    /**
+     * Set how destination IDs and offsets map onto channels
+     * @param mode DDP_MAPPING_PER_CHANNEL or DDP_MAPPING_GLOBAL
+     */
+    void setMappingMode(uint8_t mode) {
+        mappingMode = mode;
     }
     
     /**
      * Get statistics
+     * Safe from either core; each core's counters are read as one snapshot.
+     * @param rx Packets queued by Core 1
+     * @param processed Packets parsed and accepted
+     * @param dropped Packets lost before processing, all reasons
+     */
+    void getStats(uint32_t& rx, uint32_t& processed, uint32_t& dropped) const {
+        RxCounters rxCounters = rxStats.snapshot();
+        ProcessCounters processCounters = processStats.snapshot();
+        rx = rxCounters.packetsReceived;
+        processed = processCounters.packetsProcessed;
+        dropped = totalDrops(rxCounters, processCounters);
+    }
+
+    /**
+     * Get every counter with drops and rejects by reason
+     * Safe from either core.
+     * @param rx Core 1 counters
+     * @param process Core 0 counters
+     */
+    void getCounters(RxCounters& rx, ProcessCounters& process) const {
+        rx = rxStats.snapshot();
+        process = processStats.snapshot();
+    }
+
+    /**
+     * Get frame statistics
+     * @param shown Frames pushed to the strips
+     * @param incomplete Channels pushed before all their pixels were written
+     */
+    void getFrameStats(uint32_t& shown, uint32_t& incomplete) {
+        shown = framesShown;
+        incomplete = framesIncomplete;
+    }
+
+    /**
+     * Get scheduled presentation statistics
+     * @param scheduled Frames pushed with a timecode while the clock was synced
+     * @param late Of those, frames shown late or with a timecode too far ahead
+     * @param backedUp Frames complete while the previous one was still held,
+     *                 so packets queued behind them; the host lead is too long
+     */
+    void getPresentationStats(uint32_t& scheduled, uint32_t& late, uint32_t& backedUp) {
+        scheduled = framesScheduled;
+        late = framesLate;
+        backedUp = framesBackedUp;
+    }
+
+    /**
+     * Get LED output statistics
+     * @param shows Frames sent by the parallel engine
+     * @param waits Pushes that had to wait for the previous frame to finish
+     * @param waitMicros Total time those pushes waited
      */
-    void getStats(uint32_t& rx, uint32_t& processed, uint32_t& dropped) {
-        rx = packetsReceived;
-        processed = packetsProcessed;
-        dropped = packetsDropped;
+    void getOutputStats(uint32_t& shows, uint32_t& waits, uint32_t& waitMicros) {
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        parallelOutput.getStats(shows, waits, waitMicros);
+#else
+        shows = waits = waitMicros = 0;
+#endif
     }
 
     /**
@@ -199,6 +466,14 @@ public:
         return channels;
     }
 
+    /**
+     * Replace the receive source (e.g. a MemoryRxSource when running off-board)
+     * Must be called before begin().
+     */
+    void setRxSource(RxSource* source) {
+        rxSource = source ? source : &defaultRxSource;
+    }
+
     /**
      * Get number of channels
      */
@@ -214,52 +489,56 @@ public:
         uint32_t lastAckTime = 0;
         uint32_t lastAckCount = 0;
         
+        rxSource->begin();
+        bindRxSlot();
+        
         while (running) {
-            // Check for serial data
-            while (Serial.available() > 0) {
-                uint8_t byte = Serial.read();
+            // Drain received data a block at a time
+            const uint8_t* rxBlock;
+            size_t rxLen;
+            while ((rxLen = rxSource->acquire(rxBlock)) > 0) {
+                // Retry a slot if the buffer was full when the last frame ended
+                if (!rxSlot && decoder.isIdle()) {
+                    bindRxSlot();
+                }
                 
-                // Process byte through COBS decoder
-                if (decoder.processByte(byte)) {
-                    // Complete frame decoded
-                    const uint8_t* frame = decoder.getFrame();
-                    size_t frameLen = decoder.getFrameLength();
-                    
-                    // Write to circular buffer
-                    if (buffer.write(frame, frameLen)) {
-                        packetsReceived++;
-                        
-                        // Send acknowledgment for first few packets
-                        if (packetsReceived <= 5) {
-                            Serial.print("[DDPico] ACK: Packet #");
-                            Serial.print(packetsReceived);
-                            Serial.print(" received (");
-                            Serial.print(frameLen);
-                            Serial.println(" bytes)");
-                        }
-                    } else {
-                        packetsDropped++;
-                        // Log buffer overflow
-                        Serial.println("[DDPico] WARN: Buffer full - packet dropped");
+                // Process block through COBS decoder, one frame per call
+                size_t pos = 0;
+                while (pos < rxLen) {
+                    bool frameComplete;
+                    pos += decoder.receiveBlock(rxBlock + pos, rxLen - pos, frameComplete);
+                    if (frameComplete) {
+                        queueFrame();
                     }
                 }
+                
+                // Publish malformed frames the decoder dropped and bytes the
+                // source lost before they could be decoded
+                uint32_t cobsErrors = decoder.getErrorCount();
+                uint32_t overrunBytes = rxSource->getOverrunBytes();
+                if (cobsErrors != rxStats.local().dropsCobs || overrunBytes != rxStats.local().overrunBytes) {
+                    RxCounters& counters = rxStats.begin();
+                    counters.dropsCobs = cobsErrors;
+                    counters.overrunBytes = overrunBytes;
+                    rxStats.end();
+                }
+                
+                rxSource->release();
             }
             
-            // Send periodic acknowledgment every 100 packets
+            // Queue periodic acknowledgment; Core 0 writes it out when idle
+            // so this core never touches the USB link carrying pixel data
             uint32_t currentTime = millis();
-            if (packetsReceived > lastAckCount && (currentTime - lastAckTime) >= 1000) {
-                uint32_t newPackets = packetsReceived - lastAckCount;
-                Serial.print("[DDPico] ACK: ");
-                Serial.print(newPackets);
-                Serial.print(" packets received in last ");
-                Serial.print((currentTime - lastAckTime) / 1000.0, 1);
-                Serial.println("s");
+            uint32_t received = rxStats.local().packetsReceived;
+            if (!telemetryIntervalMs && received > lastAckCount && (currentTime - lastAckTime) >= 1000) {
+                DDP_LOG_EVENT(core1Log, DDP_LOG_INFO, DDP_EVT_ACK_PERIOD,
+                              received - lastAckCount, currentTime - lastAckTime);
                 lastAckTime = currentTime;
-                lastAckCount = packetsReceived;
+                lastAckCount = received;
             }
             
-            // Small delay to prevent tight loop
-            tight_loop_contents();
+            // Idle until the source may have more data
+            rxSource->wait();
         }
     }
 
@@ -273,111 +552,884 @@ private:
         }
     }
     
+    /**
+     * Point the COBS decoder at a fresh buffer slot
+     * Runs on Core 1. If the buffer is full the decoder falls back to its
+     * own storage until a slot frees up.
+     */
+    void bindRxSlot() {
+        rxSlot = buffer.claim(RX_SLOT_SIZE);
+        decoder.setOutput(rxSlot, RX_SLOT_SIZE);
+    }
+    
+    /**
+     * Publish the frame the COBS decoder just completed
+     * Runs on Core 1. Frames are normally decoded straight into a claimed
+     * buffer slot and only need committing.
+     */
+    void queueFrame() {
+        size_t frameLen = decoder.getFrameLength();
+#if DDP_PACKET_QUEUE == DDP_QUEUE_POOL
+        buffer.markFrameComplete(DDP_PROFILE_NOW());
+#endif
+        
+        if (rxSlot) {
+            buffer.commit(frameLen);
+        } else if (!buffer.write(decoder.getFrame(), frameLen)) {
+            rxStats.begin().dropsQueueFull++;
+            rxStats.end();
+            DDP_LOG_EVENT(core1Log, DDP_LOG_WARN, DDP_EVT_BUFFER_FULL, frameLen, 0);
+            bindRxSlot();
+            return;
+        }
+        
+        uint32_t received = ++rxStats.begin().packetsReceived;
+        rxStats.end();
+        bindRxSlot();
+        
+        // Acknowledge the first few packets
+        if (!telemetryIntervalMs && received <= 5) {
+            DDP_LOG_EVENT(core1Log, DDP_LOG_INFO, DDP_EVT_ACK_PACKET, received, frameLen);
+        }
+    }
+    
+    /**
+     * Parse one packet in place and apply it to the LEDs
+     * @param packetData Raw packet, owned by the buffer until released
+     * @param packetLen Packet length
+     */
+    void processPacket(const uint8_t* packetData, size_t packetLen) {
+         // Parse DDP packet
+         DDPPacket packet;
+         if (!DDPProtocol::parsePacket(packetData, packetLen, packet)) {
+             uint32_t failures = ++processStats.begin().dropsParse;
+             processStats.end();
+             
+             // Header fields of the first few failures, written out when idle
+             if (failures <= 5) {
+                 uint32_t head = 0;
+                 for (size_t i = 0; i < 4 && i < packetLen; i++) {
+                     head |= (uint32_t)packetData[i] << (24 - 8 * i);
+                 }
+                 DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_PARSE_FAILED, packetLen, head);
+                 if (packetLen >= DDP_HEADER_SIZE) {
+                     uint32_t offset = ((uint32_t)packetData[4] << 24) | ((uint32_t)packetData[5] << 16) |
+                                       ((uint32_t)packetData[6] << 8) | packetData[7];
+                     uint32_t length = ((uint32_t)packetData[8] << 8) | packetData[9];
+                     DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_PARSE_HEADER, offset, length);
+                 }
+             }
+             return;
+         }
+         
+         uint32_t parsedAt = DDP_PROFILE_NOW();
+         profiler.record(Profiler::STAGE_QUEUE_WRITE, packetCompletedAt, packetQueuedAt);
+         profiler.record(Profiler::STAGE_QUEUE_WAIT, packetQueuedAt, packetReadAt);
+         profiler.record(Profiler::STAGE_PARSE, packetReadAt, parsedAt);
+         
+         // Sequence numbers are only counted; stale fragments are dropped if enabled
+         SequenceTracker::Result order = sequence.track(packet.destId, packet.sequence, packet.shouldPush());
+         if (DDP_DROP_STALE && order == SequenceTracker::SEQ_STALE) {
+             processStats.begin().dropsStale++;
+             processStats.end();
+             return;
+         }
+         
+         uint32_t processed = ++processStats.begin().packetsProcessed;
+         processStats.end();
+         
+         // Queries are answered, not applied; only the status ID has an answer
+         if (packet.isQuery()) {
+             if (packet.destId == DDP_ID_STATUS) {
+                 sendStatusReply(packet);
+             } else {
+                 processStats.begin().rejectedDest++;
+                 processStats.end();
+                 DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_BAD_DEST, packet.destId, 0);
+             }
+             return;
+         }
+         
+         DDP_LOGD("✓ Processing packet #%lu - Offset: %lu, Length: %u, Push: %s",
+                  (unsigned long)processed, (unsigned long)packet.dataOffset,
+                  packet.dataLength, packet.shouldPush() ? "YES" : "NO");
+         
+         // Apply pixel data to LEDs (a push marks the frame for output)
+         applyPixelData(packet);
+         uint32_t appliedAt = DDP_PROFILE_NOW();
+         profiler.record(Profiler::STAGE_APPLY, parsedAt, appliedAt);
+         
+         if (packet.shouldPush() && pushedMask) {
+             // The latest push starts the frame's hold and end-to-end time
+             pushCompletedAt = packetCompletedAt;
+             pushAppliedAt = appliedAt;
+             
+             // The timecode of a push is when its frame should be shown
+             if (packet.hasTimecode()) {
+                 presentTimecode = packet.timecode;
+                 presentPending = true;
+             }
+         }
+    }
+    
     /**
      * Apply DDP pixel data to LEDs
      */
     void applyPixelData(const DDPPacket& packet) {
+         if (packet.destId == DDP_ID_CONFIG) {
+             applyConfig(packet);
+             return;
+         }
+
+         uint32_t startPixel = packet.dataOffset / packet.getPixelBytes();  // Offset is in bytes, convert to pixels
+         uint16_t pixelCount = DDPProtocol::getPixelCount(packet);
+
+         // Log first pixel of first packet
+         if (processStats.local().packetsProcessed == 1) {
+             DDP_LOGD("First pixel RGB: (%u, %u, %u)", packet.data[0], packet.data[1], packet.data[2]);
+         }
+
+         if (packet.destId == DDP_ID_BROADCAST) {
+             applyBroadcast(packet, startPixel, pixelCount);
+             return;
+         }
+         if (mappingMode == DDP_MAPPING_GLOBAL) {
+             applyGlobal(packet, startPixel, pixelCount);
+             return;
+         }
+
          // Determine channel index from destination ID (1-based to 0-based)
          uint8_t channelIndex = packet.destId - 1;
 
          // Validate channel
          if (channelIndex >= numChannels || !channels[channelIndex].orb) {
-             Serial.print("[DDPico] WARN: Invalid destination ID ");
-             Serial.print(packet.destId);
-             Serial.println(" - no such channel");
+             processStats.begin().rejectedDest++;
+             processStats.end();
+             DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_BAD_DEST, packet.destId, 0);
              return;
          }
 
-         Orb* orb = channels[channelIndex].orb;
-         BrightnessLimiter* limiter = channels[channelIndex].limiter;
-
-         uint16_t pixelCount = DDPProtocol::getPixelCount(packet);
-         uint16_t startPixel = packet.dataOffset / 3;  // Offset is in bytes, convert to pixels
-
-         // Log ALL pixel applications for debugging
-         Serial.print("[DDPico] Applying pixels to Channel ");
-         Serial.print(channelIndex + 1);
-         Serial.print(" - Start: ");
-         Serial.print(startPixel);
-         Serial.print(", Count: ");
-         Serial.print(pixelCount);
-         Serial.print(", Total LEDs: ");
-         Serial.println(orb->numLEDs);
+         LEDChannel& channel = channels[channelIndex];
 
          // Bounds check
-         if (startPixel >= orb->numLEDs) {
-             Serial.print("[DDPico] WARN: Start pixel ");
-             Serial.print(startPixel);
-             Serial.print(" >= LED count ");
-             Serial.println(orb->numLEDs);
+         if (startPixel >= channel.numLEDs) {
+             processStats.begin().rejectedRange++;
+             processStats.end();
+             DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_OUT_OF_RANGE, startPixel, channel.numLEDs);
              return;
          }
 
          // Limit to available LEDs
-         if (startPixel + pixelCount > orb->numLEDs) {
-             pixelCount = orb->numLEDs - startPixel;
+         if (startPixel + pixelCount > channel.numLEDs) {
+             pixelCount = channel.numLEDs - startPixel;
          }
 
-         // Apply pixel data
-         // Apply brightness limiting
-         limiter->limitBrightness((uint8_t*)packet.data, pixelCount);
+         applyToChannel(channel, startPixel, packet.data, pixelCount, packet);
+
+         // Push to display if requested
+         if (packet.shouldPush()) {
+             DDP_LOGD("✓ Push received for channel %u", channelIndex + 1);
+             markPushed(1 << channelIndex);
+         } else {
+             DDP_LOGD("⚠ Push flag NOT set - LEDs not updated");
+         }
+    }
+    
+    /**
+     * Apply a packet addressed to the global offset space
+     * The channels sit back to back in one virtual strip, so one payload
+     * may continue from the end of one channel into the next. The span
+     * table gives each channel's first pixel; only the first channel is
+     * looked up, the rest follow in order.
+     */
+    void applyGlobal(const DDPPacket& packet, uint32_t startPixel, uint16_t pixelCount) {
+         if (packet.destId != DDP_ID_DEFAULT) {
+             processStats.begin().rejectedDest++;
+             processStats.end();
+             DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_BAD_DEST, packet.destId, 0);
+             return;
+         }
+         if (startPixel >= totalLEDs) {
+             processStats.begin().rejectedRange++;
+             processStats.end();
+             DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_OUT_OF_RANGE, startPixel, totalLEDs);
+             return;
+         }
+
+         uint8_t ch = numChannels - 1;
+         while (channelStart[ch] > startPixel) {
+             ch--;
+         }
 
          const uint8_t* data = packet.data;
-         for (uint16_t i = 0; i < pixelCount; i++) {
-             uint16_t pixelIndex = startPixel + i;
-             uint8_t r = data[i * 3];
-             uint8_t g = data[i * 3 + 1];
-             uint8_t b = data[i * 3 + 2];
-
-             orb->pixelSet(pixelIndex, r, g, b);
-
-             // Log first pixel of first packet
-             if (packetsProcessed == 1 && i == 0) {
-                 Serial.print("[DDPico] First pixel RGB: (");
-                 Serial.print(r);
-                 Serial.print(", ");
-                 Serial.print(g);
-                 Serial.print(", ");
-                 Serial.print(b);
-                 Serial.println(")");
+         while (pixelCount > 0 && ch < numChannels) {
+             uint16_t localStart = startPixel - channelStart[ch];
+             uint16_t count = min(pixelCount, (uint16_t)(channels[ch].numLEDs - localStart));
+             applyToChannel(channels[ch], localStart, data, count, packet);
+             data += count * packet.getPixelBytes();
+             startPixel += count;
+             pixelCount -= count;
+             ch++;
+         }
+
+         // A push completes the frame of the whole controller
+         if (packet.shouldPush()) {
+             markPushed(allChannelsMask());
+         }
+    }
+    
+    /**
+     * Apply a packet to every channel (DDP_ID_BROADCAST)
+     * Offsets are within each strip, as with per-channel addressing. The
+     * data is converted once per distinct strip layout and color correction;
+     * channels that match an earlier one copy its converted run instead.
+     */
+    void applyBroadcast(const DDPPacket& packet, uint32_t startPixel, uint16_t pixelCount) {
+         uint16_t runCount[MAX_LED_CHANNELS] = {0};
+         bool applied = false;
+
+         for (uint8_t i = 0; i < numChannels; i++) {
+             LEDChannel& channel = channels[i];
+             if (startPixel >= channel.numLEDs) {
+                 continue;
+             }
+             uint16_t count = min(pixelCount, (uint16_t)(channel.numLEDs - startPixel));
+             uint8_t elements = channel.orb->getBytesPerPixel();
+             runCount[i] = count;
+             applied = true;
+
+             // Find an earlier channel that already holds this run
+             uint8_t source = 0;
+             while (source < i && !(runCount[source] >= count &&
+                                    channels[source].lutClass == channel.lutClass &&
+                                    channels[source].orb->getBytesPerPixel() == elements)) {
+                 source++;
              }
+             if (source == i) {
+                 applyToChannel(channel, startPixel, packet.data, count, packet);
+                 continue;
+             }
+
+             const uint16_t* from = channels[source].frame + startPixel * elements;
+             uint16_t* to = channel.frame + startPixel * elements;
+             int32_t litDelta = PixelConvert::countLit(from, elements, count) -
+                                PixelConvert::countLit(to, elements, count);
+             memcpy(to, from, count * elements * sizeof(uint16_t));
+             channel.limiter->adjustLitCount(litDelta);
+             channel.dirty.mark(startPixel, count);
          }
 
-         // Push to display if requested
+         if (!applied) {
+             processStats.begin().rejectedRange++;
+             processStats.end();
+             DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_OUT_OF_RANGE, startPixel, 0);
+             return;
+         }
          if (packet.shouldPush()) {
-             Serial.println("[DDPico] ✓ Calling pixelsShow() to update LEDs");
-             orb->pixelsShow();
-             Serial.println("[DDPico] ✓ pixelsShow() completed");
-         } else {
-             Serial.println("[DDPico] ⚠ Push flag NOT set - LEDs not updated");
+             markPushed(allChannelsMask());
          }
     }
     
+    /**
+     * Convert a run of pixels into a channel's back buffer
+     * Keeps the lit LED count current so limiting can wait for the whole frame.
+     * @param channel Target channel
+     * @param startPixel First pixel within the channel
+     * @param data Pixel data in the packet's format
+     * @param pixelCount Number of pixels, already clipped to the channel
+     * @param packet Packet the data belongs to
+     */
+    void applyToChannel(LEDChannel& channel, uint16_t startPixel, const uint8_t* data,
+                        uint16_t pixelCount, const DDPPacket& packet) {
+         DDP_LOGD("Applying pixels to pin %u - Start: %u, Count: %u, Total LEDs: %u",
+                  channel.pin, startPixel, pixelCount, channel.numLEDs);
+
+         uint8_t frameElements = channel.orb->getBytesPerPixel();
+         int32_t litDelta = PixelConvert::convert(channel.frame + startPixel * frameElements,
+                                                  frameElements, data, packet.elements, packet.elementBytes,
+                                                  pixelCount, *channel.lut);
+         channel.limiter->adjustLitCount(litDelta);
+         channel.dirty.mark(startPixel, pixelCount);
+    }
+    
+    /**
+     * Apply a config packet (DDP_ID_CONFIG)
+     * Replaced tables take effect for fragments received from then on.
+     * Tables are sent as 256 8-bit entries, or as 256 big-endian 8.8 fixed
+     * point entries (512 bytes) to keep sub-8-bit precision.
+     */
+    void applyConfig(const DDPPacket& packet) {
+        const uint8_t* data = packet.data;
+        uint16_t length = packet.dataLength;
+        uint8_t command = data[0];
+
+        if (command == DDP_CONFIG_TIME_SYNC && length >= 6) {
+            uint32_t timecode = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) |
+                                ((uint32_t)data[4] << 8) | data[5];
+            clock.sync(timecode, micros());
+            return;
+        }
+
+        // Channel 0 addresses every channel
+        uint8_t first = 0;
+        uint8_t last = numChannels;
+        if (length >= 2 && data[1] != 0) {
+            first = data[1] - 1;
+            last = data[1];
+        }
+
+        bool valid = length >= 2 && last <= numChannels;
+        if (valid && command == DDP_CONFIG_LUT && length >= 3 + 256) {
+            bool wide = length >= 3 + 512;
+            for (uint8_t ch = first; ch < last; ch++) {
+                for (uint8_t e = 0; e < 4; e++) {
+                    if (!(data[2] & (1 << e))) {
+                        continue;
+                    }
+                    uint16_t* table = channels[ch].lut->table[e];
+                    for (uint16_t i = 0; i < 256; i++) {
+                        table[i] = wide ? ((uint16_t)data[3 + 2 * i] << 8) | data[4 + 2 * i]
+                                        : (uint16_t)data[3 + i] << 8;
+                    }
+                }
+            }
+        } else if (valid && command == DDP_CONFIG_LUT_RESET) {
+            for (uint8_t ch = first; ch < last; ch++) {
+                *channels[ch].lut = ColorCorrection::defaults();
+            }
+        } else {
+            processStats.begin().rejectedConfig++;
+            processStats.end();
+            DDP_LOG_EVENT(core0Log, DDP_LOG_WARN, DDP_EVT_BAD_CONFIG, command, length);
+            return;
+        }
+        updateLutClasses();
+    }
+    
+    /**
+     * Group channels with identical color correction tables
+     * Broadcast packets convert once per group. Only runs when tables change.
+     */
+    void updateLutClasses() {
+        for (uint8_t ch = 0; ch < numChannels; ch++) {
+            channels[ch].lutClass = ch;
+            for (uint8_t other = 0; other < ch; other++) {
+                if (memcmp(channels[other].lut, channels[ch].lut, sizeof(ColorLUT)) == 0) {
+                    channels[ch].lutClass = channels[other].lutClass;
+                    break;
+                }
+            }
+        }
+    }
+    
+    /**
+     * Note a push for some channels
+     * @param mask Bit i set for channel i
+     */
+    void markPushed(uint8_t mask) {
+        if (!pushedMask) {
+            pushSinceUs = micros();
+        }
+        pushedMask |= mask;
+    }
+    
+    /**
+     * Check if the pending pushes complete a frame
+     * Ready once every channel that pushed in the previous frame has pushed
+     * again, or when the oldest pending push has waited DDP_PUSH_HOLD_US.
+     */
+    bool framePushReady() const {
+        if (!pushedMask) {
+            return false;
+        }
+        return (pushedMask & expectedMask) == expectedMask ||
+               micros() - pushSinceUs >= DDP_PUSH_HOLD_US;
+    }
+    
+    /**
+     * Check if a frame with a timecode may be shown
+     * Timecodes further ahead than DDP_PRESENT_MAX_LEAD_US are shown at once.
+     */
+    bool presentationDue(uint32_t timecode) const {
+        int32_t wait = clock.microsUntil(timecode, micros());
+        return wait <= 0 || wait > DDP_PRESENT_MAX_LEAD_US;
+    }
+    
+    /**
+     * Commit the assembled frames of all changed channels together
+     * Every channel written since the last push is copied to its front
+     * buffer and rendered, whichever channel the push came from. Channels
+     * pushed with part of their pixels unwritten are counted as incomplete.
+     * A frame whose timecode is not due yet is held (presentHeld) until
+     * presentFrame() shows it; frames without a timecode, or received
+     * before the clock was synced, are due at once.
+     */
+    void commitFrame() {
+        uint32_t start = micros();
+        uint32_t startAt = DDP_PROFILE_NOW();
+        uint8_t shown = 0;
+        for (uint8_t i = 0; i < numChannels; i++) {
+            LEDChannel& channel = channels[i];
+            if (!channel.dirty.any()) {
+                continue;
+            }
+            if (!channel.dirty.full()) {
+                framesIncomplete++;
+                DDP_LOG_EVENT(core0Log, DDP_LOG_DEBUG, DDP_EVT_INCOMPLETE, i + 1, framesShown);
+            }
+            commitChannel(channel);
+            shown |= 1 << i;
+        }
+        
+        expectedMask = pushedMask;
+        pushedMask = 0;
+        frameMask = shown;
+        frameTimed = presentPending && clock.isSynced();
+        frameTimecode = presentTimecode;
+        presentPending = false;
+        presentHeld = frameTimed && shown && !presentationDue(frameTimecode);
+        if (!shown) {
+            return;
+        }
+        
+        renderMicros = micros() - start;
+        framePushCompletedAt = pushCompletedAt;
+        profiler.record(Profiler::STAGE_PUSH_HOLD, pushAppliedAt, startAt);
+        profiler.record(Profiler::STAGE_RENDER, startAt, DDP_PROFILE_NOW());
+    }
+    
+    /**
+     * Show the frame committed by commitFrame() on the strips, all at once
+     */
+    void presentFrame() {
+        presentHeld = false;
+        if (frameTimed) {
+            int32_t wait = clock.microsUntil(frameTimecode, micros());
+            framesScheduled++;
+            if (wait < -DDP_PRESENT_LATE_US || wait > DDP_PRESENT_MAX_LEAD_US) {
+                framesLate++;
+            }
+            // The next frame completed while this one was held
+            if (framePushReady()) {
+                framesBackedUp++;
+            }
+        }
+        if (!frameMask) {
+            return;
+        }
+        
+        framesShown++;
+        updateFrameRate();
+        uint32_t showAt = DDP_PROFILE_NOW();
+        showStrips(frameMask);
+        lastRefreshUs = micros();
+        
+        uint32_t shownAt = DDP_PROFILE_NOW();
+        profiler.record(Profiler::STAGE_SHOW, showAt, shownAt);
+        profiler.record(Profiler::STAGE_END_TO_END, framePushCompletedAt, shownAt);
+    }
+    
+    /**
+     * Recompute the frame rate once a second
+     */
+    void updateFrameRate() {
+        uint32_t now = millis();
+        uint32_t elapsed = now - rateStartMs;
+        if (elapsed >= 1000) {
+            frameRateX10 = (uint16_t)min((framesShown - rateStartFrames) * 10000 / elapsed, (uint32_t)0xFFFF);
+            rateStartMs = now;
+            rateStartFrames = framesShown;
+        }
+    }
+    
+    /**
+     * Sum the packets lost before processing
+     * Rejected packets were parsed and count as processed, not dropped.
+     */
+    static uint32_t totalDrops(const RxCounters& rx, const ProcessCounters& process) {
+        return rx.dropsQueueFull + rx.dropsCobs + process.dropsParse + process.dropsStale;
+    }
+    
+    /**
+     * Answer a query with the status reply (see DDP_STATUS_VERSION)
+     * Sent as its own COBS frame on the serial link, with a leading
+     * delimiter so it cannot merge with a text line.
+     */
+    void sendStatusReply(const DDPPacket& query) {
+        static constexpr size_t MAX_REPLY = DDP_HEADER_SIZE + DDP_STATUS_HEADER_SIZE +
+                                            DDP_STATUS_CHANNEL_SIZE * MAX_LED_CHANNELS;
+        static_assert(MAX_REPLY <= HOST_FRAME_MAX, "Status reply does not fit a host frame");
+        uint8_t reply[MAX_REPLY];
+        uint8_t* p = reply + DDP_HEADER_SIZE;
+        
+        updateFrameRate();
+        uint8_t engine = DDP_OUTPUT_SEQUENTIAL;
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        if (parallelOutput.isActive()) {
+            engine = DDP_OUTPUT_PARALLEL;
+        }
+#endif
+        
+        *p++ = DDP_STATUS_VERSION;
+        *p++ = numChannels;
+        *p++ = mappingMode;
+        *p++ = engine;
+        const RxCounters rx = rxStats.snapshot();
+        const ProcessCounters& process = processStats.local();
+        p = DDPProtocol::putBE32(p, rx.packetsReceived);
+        p = DDPProtocol::putBE32(p, process.packetsProcessed);
+        p = DDPProtocol::putBE32(p, totalDrops(rx, process));
+        p = DDPProtocol::putBE32(p, framesShown);
+        p = DDPProtocol::putBE16(p, (uint16_t)(buffer.getUsagePercent() * 10));
+        p = DDPProtocol::putBE16(p, frameRateX10);
+        for (uint8_t i = 0; i < numChannels; i++) {
+            *p++ = channels[i].pin;
+            *p++ = channels[i].orb->getBytesPerPixel();
+            p = DDPProtocol::putBE16(p, channels[i].numLEDs);
+        }
+        
+        uint16_t length = p - reply - DDP_HEADER_SIZE;
+        reply[0] = DDP_FLAG_VER1 | DDP_FLAG_REPLY;
+        reply[1] = query.sequence;
+        reply[2] = 0;
+        reply[3] = query.destId;
+        DDPProtocol::putBE32(reply + 4, 0);
+        DDPProtocol::putBE16(reply + 8, length);
+        
+        sendFrame(reply, DDP_HEADER_SIZE + length);
+    }
+    
+    /**
+     * Send the telemetry record (see Telemetry.h)
+     * Skipped if the USB transmit buffer cannot take it without blocking;
+     * the next idle pass tries again.
+     */
+    void sendTelemetry() {
+        static constexpr size_t FRAME_SIZE = COBSEncoder::maxEncodedLength(TelemetryRecord::SIZE) + 2;
+        if (Serial.availableForWrite() < (int)FRAME_SIZE) {
+            return;
+        }
+        
+        TelemetryRecord record;
+        const SequenceTracker::Stats& seq = sequence.getStats();
+        const RxCounters rx = rxStats.snapshot();
+        const ProcessCounters& process = processStats.local();
+        record.uptimeMs = millis();
+        record.packetsReceived = rx.packetsReceived;
+        record.packetsProcessed = process.packetsProcessed;
+        record.dropsQueueFull = rx.dropsQueueFull;
+        record.dropsParse = process.dropsParse;
+        record.dropsStale = process.dropsStale;
+        record.packetsRejected = process.rejectedDest + process.rejectedRange + process.rejectedConfig;
+        record.dropsCobs = rx.dropsCobs;
+        record.rejectedDest = process.rejectedDest;
+        record.rejectedRange = process.rejectedRange;
+        record.rejectedConfig = process.rejectedConfig;
+        record.logDropped = core0Log.getDropped() + core1Log.getDropped();
+        record.rxOverrunBytes = rx.overrunBytes;
+        record.framesShown = framesShown;
+        record.framesIncomplete = framesIncomplete;
+        record.sequenceGaps = seq.gaps;
+        record.sequenceMissing = seq.missing;
+        record.sequenceDuplicates = seq.duplicates;
+        record.sequenceLate = seq.late;
+        record.framesScheduled = framesScheduled;
+        record.framesLate = framesLate;
+        getOutputStats(record.outputShows, record.outputWaits, record.outputWaitMicros);
+        record.renderMicros = renderMicros;
+        record.queueUsage = (uint16_t)(buffer.getUsagePercent() * 10);
+        updateFrameRate();
+        record.frameRate = frameRateX10;
+        
+        static_assert(TelemetryRecord::SIZE <= HOST_FRAME_MAX, "Telemetry record does not fit a host frame");
+        uint8_t data[TelemetryRecord::SIZE];
+        sendFrame(data, record.serialize(data));
+        lastTelemetryTime = millis();
+        profileNextStage = 0;
+    }
+    
+#if DDP_PROFILE
+    /**
+     * Send the stage timing after each telemetry record, one frame per stage
+     * Continues on later idle passes while the USB transmit buffer is short.
+     */
+    void sendProfile() {
+        static constexpr size_t FRAME_SIZE = COBSEncoder::maxEncodedLength(LatencyStats::WIRE_SIZE) + 2;
+        static_assert(LatencyStats::WIRE_SIZE <= HOST_FRAME_MAX, "Profile frame does not fit a host frame");
+        while (profileNextStage < Profiler::STAGE_COUNT && Serial.availableForWrite() >= (int)FRAME_SIZE) {
+            uint8_t data[LatencyStats::WIRE_SIZE];
+            Profiler::Stage stage = (Profiler::Stage)profileNextStage;
+            sendFrame(data, profiler.get(stage).serialize(stage, data));
+            profileNextStage++;
+        }
+    }
+#endif
+    
+    /**
+     * Send a binary frame to the host: 0x00 <COBS> 0x00
+     * The leading delimiter ends any partial text line on the host side.
+     * @param data Frame, at most HOST_FRAME_MAX bytes
+     * @param length Frame length
+     */
+    void sendFrame(const uint8_t* data, size_t length) {
+        uint8_t frame[COBSEncoder::maxEncodedLength(HOST_FRAME_MAX) + 2];
+        size_t encoded = COBSEncoder::encode(data, length, frame + 1);
+        frame[0] = 0x00;
+        frame[encoded + 1] = 0x00;
+        Serial.write(frame, encoded + 2);
+    }
+
+    
+    /**
+     * Copy the changed parts of a channel's back buffer to its front buffer and render it
+     * Unmarked pixels are the same in both buffers already. The brightness
+     * scale is taken once for the whole frame.
+     */
+    void commitChannel(LEDChannel& channel) {
+        uint8_t elements = channel.orb->getBytesPerPixel();
+        for (uint16_t pos = 0, n; channel.dirty.nextRun(pos, n); pos += n) {
+            memcpy(channel.front + pos * elements, channel.frame + pos * elements,
+                   n * elements * sizeof(uint16_t));
+        }
+        channel.dirty.clear();
+        channel.frontScale = channel.limiter->getFrameScale();
+        renderChannel(channel);
+    }
+    
+    /**
+     * Mask with a bit for every configured channel
+     */
+    uint8_t allChannelsMask() const {
+        return (uint8_t)((1u << numChannels) - 1);
+    }
+    
+    /**
+     * Re-send every channel's front buffer
+     * Each refresh carries the dither one step further, so levels between
+     * 8-bit steps average out over successive refreshes.
+     */
+    void refresh() {
+        for (uint8_t i = 0; i < numChannels; i++) {
+            renderChannel(channels[i]);
+        }
+        showStrips(allChannelsMask());
+        lastRefreshUs = micros();
+    }
+    
+    /**
+     * Scale and dither a front buffer into its strip buffer in one pass
+     */
+    void renderChannel(LEDChannel& channel) {
+        channel.orb->pixelsWriteDithered(0, channel.front, channel.numLEDs, channel.frontScale, channel.residual);
+    }
+    
+    /**
+     * Check if the strips are still busy with the previous frame
+     */
+    bool outputBusy() const {
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        return parallelOutput.isActive() && parallelOutput.isBusy();
+#else
+        return false;
+#endif
+    }
+    
+    /**
+     * Send pixel buffers out to the strips
+     * The parallel engine refreshes every channel at once and returns as
+     * soon as the buffers are encoded, so parsing carries on while DMA
+     * sends the frame. Otherwise only the channels in the mask are shown,
+     * blocking.
+     * @param mask Bit i set for channel i
+     */
+    void showStrips(uint8_t mask) {
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        if (parallelOutput.isActive()) {
+            const uint8_t* lanes[MAX_LED_CHANNELS];
+            size_t lengths[MAX_LED_CHANNELS];
+            for (uint8_t i = 0; i < numChannels; i++) {
+                lanes[i] = channels[i].orb->getPixels();
+                lengths[i] = channels[i].orb->getPixelBytes();
+            }
+            parallelOutput.show(lanes, lengths);
+            return;
+        }
+#endif
+        for (uint8_t i = 0; i < numChannels; i++) {
+            if (mask & (1 << i)) {
+                channels[i].orb->pixelsShow();
+            }
+        }
+    }
+    
+    /**
+     * Background work while no packets are waiting (Core 0)
+     * Drains deferred log records and prints periodic stats, but only as
+     * much as the USB transmit buffer takes without blocking.
+     */
+    void idle() {
+        drainLog(core1Log);
+        drainLog(core0Log);
+        
+        // Telemetry replaces the stats text
+        if (telemetryIntervalMs) {
+            if (millis() - lastTelemetryTime >= telemetryIntervalMs) {
+                sendTelemetry();
+            }
+#if DDP_PROFILE
+            sendProfile();
+#endif
+            return;
+        }
+        
+        // Print stats periodically
+        if (millis() - lastStatsTime >= 5000) {
+            if (DDP_LOG_ENABLED(DDP_LOG_INFO)) {
+                printStats();
+            }
+            lastStatsTime = millis();
+        }
+    }
+    
+    /**
+     * Format queued log records to serial
+     */
+    template<typename Ring>
+    void drainLog(Ring& ring) {
+        typename Ring::Record record;
+        while (Serial.availableForWrite() >= DDP_LOG_DRAIN_MIN_SPACE && ring.pop(record)) {
+            Serial.printf(ddpLogEventFormat(record.event),
+                          (unsigned long)record.arg0, (unsigned long)record.arg1);
+        }
+    }
+    
     /**
      * Print statistics to serial
      */
     void printStats() {
         float bufferUsage = buffer.getUsagePercent();
+        const RxCounters rx = rxStats.snapshot();
+        const ProcessCounters& process = processStats.local();
         
         Serial.print("[DDPico] Stats - RX: ");
-        Serial.print(packetsReceived);
+        Serial.print(rx.packetsReceived);
         Serial.print(" | Processed: ");
-        Serial.print(packetsProcessed);
+        Serial.print(process.packetsProcessed);
         Serial.print(" | Dropped: ");
-        Serial.print(packetsDropped);
+        Serial.print(totalDrops(rx, process));
         Serial.print(" | Buffer: ");
         Serial.print(bufferUsage, 1);
         Serial.println("%");
+
+        Serial.printf("[DDPico] Drops - Queue full: %lu | COBS: %lu | Parse: %lu | Stale: %lu | Log records: %lu"
+                      " | RX overrun: %lu bytes\r\n",
+                      (unsigned long)rx.dropsQueueFull, (unsigned long)rx.dropsCobs,
+                      (unsigned long)process.dropsParse, (unsigned long)process.dropsStale,
+                      (unsigned long)(core0Log.getDropped() + core1Log.getDropped()),
+                      (unsigned long)rx.overrunBytes);
+        Serial.printf("[DDPico] Rejected - Bad destination: %lu | Out of range: %lu | Bad config: %lu\r\n",
+                      (unsigned long)process.rejectedDest, (unsigned long)process.rejectedRange,
+                      (unsigned long)process.rejectedConfig);
+
+        Serial.printf("[DDPico] Frames - Shown: %lu | Incomplete: %lu\r\n",
+                      (unsigned long)framesShown, (unsigned long)framesIncomplete);
+
+        if (clock.isSynced()) {
+            Serial.printf("[DDPico] Presentation - Scheduled: %lu | Late: %lu | Backed up: %lu\r\n",
+                          (unsigned long)framesScheduled, (unsigned long)framesLate,
+                          (unsigned long)framesBackedUp);
+        }
+
+        const SequenceTracker::Stats& seq = sequence.getStats();
+        Serial.printf("[DDPico] Sequence - Gaps: %lu (%lu missing) | Duplicates: %lu | Late: %lu | Stale: %lu\r\n",
+                      (unsigned long)seq.gaps, (unsigned long)seq.missing, (unsigned long)seq.duplicates,
+                      (unsigned long)seq.late, (unsigned long)seq.stale);
+
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+        if (parallelOutput.isActive()) {
+            uint32_t shows, waits, waitMicros;
+            parallelOutput.getStats(shows, waits, waitMicros);
+            Serial.printf("[DDPico] Output - Frames: %lu | Waited: %lu (%lu us)\r\n",
+                          (unsigned long)shows, (unsigned long)waits, (unsigned long)waitMicros);
+        }
+#endif
     }
     
     LEDChannel channels[MAX_LED_CHANNELS];
     uint8_t numChannels;
-    CircularBuffer<DDP_CIRCULAR_BUFFER_SIZE> buffer;
+    DDPPacketQueue buffer;
     COBSDecoder decoder;
+    uint8_t* rxSlot;  // Buffer slot the decoder is writing into (Core 1 only)
+    DDPRxSource defaultRxSource;
+    RxSource* rxSource;
+    
+#if DDP_OUTPUT_ENGINE == DDP_OUTPUT_PARALLEL
+    ParallelOutput parallelOutput;
+#endif
+    
+    // Deferred log records, one ring per producing core
+    DDPLogRing<DDP_LOG_RING_SIZE> core0Log;
+    DDPLogRing<DDP_LOG_RING_SIZE> core1Log;
+    
+    // Largest binary frame sent to the host (status reply, telemetry)
+    static constexpr size_t HOST_FRAME_MAX = 128;
+    
+    // Claim size for decoder output slots, and the size of the decoder's own
+    // buffer used while no slot is free, so a frame too long for a slot is
+    // dropped as a COBS error on either path rather than as a full queue
+    static constexpr size_t RX_SLOT_SIZE =
+        (DDPPacketQueue::MAX_RECORD_SIZE < DDP_COBS_MAX_FRAME_SIZE) ? DDPPacketQueue::MAX_RECORD_SIZE
+                                                                     : DDP_COBS_MAX_FRAME_SIZE;
 
-    volatile bool running;
-    volatile uint32_t packetsReceived;
-    volatile uint32_t packetsProcessed;
-    volatile uint32_t packetsDropped;
+    std::atomic<bool> running;  // Read by Core 1
+    
+    // Statistics, one block per writing core (see StatsCounters.h)
+    CounterBlock<RxCounters> rxStats;            // Core 1
+    CounterBlock<ProcessCounters> processStats;  // Core 0
+    uint32_t telemetryIntervalMs;
+    uint32_t lastTelemetryTime;
     uint32_t lastStatsTime;
+    SequenceTracker sequence;  // Core 0
+    
+    // Frame assembly (Core 0): pushes are collected per channel until the frame is complete
+    uint32_t framesShown;
+    uint32_t renderMicros;     // Commit and render time of the last frame
+    uint32_t rateStartMs;      // Frame rate window
+    uint32_t rateStartFrames;
+    uint16_t frameRateX10;
+    uint32_t framesIncomplete;
+    uint8_t pushedMask;    // Channels pushed since the last frame was shown
+    uint8_t expectedMask;  // Channels that pushed in the previous frame
+    uint32_t pushSinceUs;  // Time of the oldest pending push
+    
+    // Stage timing (DDP_PROFILE); stamps are 0 when compiled out
+    Profiler profiler;
+    uint32_t packetCompletedAt;  // Stamps of the packet being processed
+    uint32_t packetQueuedAt;
+    uint32_t packetReadAt;
+    uint32_t pushCompletedAt;    // Stamps of the latest push of the pending frame
+    uint32_t pushAppliedAt;
+    uint32_t framePushCompletedAt;  // Push stamp of the committed frame
+    uint8_t profileNextStage;    // Next stage frame to send, STAGE_COUNT when done
+    
+    // Scheduled presentation (Core 0)
+    PresentationClock clock;
+    bool presentPending;       // Pending frame has a timecode
+    uint32_t presentTimecode;
+    bool presentHeld;          // Committed frame waits in the front buffers for its timecode
+    bool frameTimed;           // Committed frame has a timecode and the clock was synced
+    uint32_t frameTimecode;
+    uint8_t frameMask;         // Channels of the committed frame
+    uint32_t framesScheduled;
+    uint32_t framesLate;
+    uint32_t framesBackedUp;   // Frames complete while the previous one was still held
+    
+    // Address mapping; channelStart is each channel's first pixel in the global offset space
+    uint8_t mappingMode;
+    uint32_t channelStart[MAX_LED_CHANNELS];
+    uint32_t totalLEDs;
+    
+    // Refresh scheduler (Core 0)
+    uint32_t refreshPeriodUs;
+    uint32_t lastRefreshUs;
 };
@@ -0,0 +1,144 @@
+#pragma once
+#include <Platform.h>
+#include <atomic>
+
+// Log levels
+#define DDP_LOG_NONE  0
+#define DDP_LOG_ERROR 1
+#define DDP_LOG_WARN  2
+#define DDP_LOG_INFO  3
+#define DDP_LOG_DEBUG 4
+
+// Compile-time ceiling: anything above it is compiled out completely.
+// Per-packet tracing is DEBUG, so release builds keep the hot path silent.
+#ifndef DDP_LOG_LEVEL
+#define DDP_LOG_LEVEL DDP_LOG_INFO
+#endif
+
+// Runtime level, can only lower what DDP_LOG_LEVEL allows (definition in DDPController.cpp)
+extern uint8_t g_ddpLogLevel;
+
+#define DDP_LOG_ENABLED(level) (DDP_LOG_LEVEL >= (level) && g_ddpLogLevel >= (level))
+
+// Immediate logging: formatted and written to Serial at the call site
+#define DDP_LOG_PRINT(level, fmt, ...) \
+    do { \
+        if (DDP_LOG_ENABLED(level)) { \
+            Serial.printf("[DDPico] " fmt "\r\n", ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define DDP_LOGE(fmt, ...) DDP_LOG_PRINT(DDP_LOG_ERROR, fmt, ##__VA_ARGS__)
+#define DDP_LOGW(fmt, ...) DDP_LOG_PRINT(DDP_LOG_WARN, fmt, ##__VA_ARGS__)
+#define DDP_LOGI(fmt, ...) DDP_LOG_PRINT(DDP_LOG_INFO, fmt, ##__VA_ARGS__)
+#define DDP_LOGD(fmt, ...) DDP_LOG_PRINT(DDP_LOG_DEBUG, fmt, ##__VA_ARGS__)
+
+// Deferred logging: a binary record is queued and only formatted when the
+// output core drains the ring while idle
+#define DDP_LOG_EVENT(ring, level, event, arg0, arg1) \
+    do { \
+        if (DDP_LOG_ENABLED(level)) { \
+            (ring).push((level), (event), (arg0), (arg1)); \
+        } \
+    } while (0)
+
+/**
+ * Deferred log events
+ */
+enum DDPLogEvent : uint8_t {
+    DDP_EVT_ACK_PACKET,     // arg0: packet number, arg1: frame bytes
+    DDP_EVT_ACK_PERIOD,     // arg0: packets received, arg1: period in ms
+    DDP_EVT_BUFFER_FULL,    // arg0: frame bytes
+    DDP_EVT_BAD_DEST,       // arg0: destination ID
+    DDP_EVT_OUT_OF_RANGE,   // arg0: start pixel, arg1: channel LED count
+    DDP_EVT_BAD_CONFIG,     // arg0: command, arg1: payload bytes
+    DDP_EVT_INCOMPLETE,     // arg0: channel, arg1: frame number
+    DDP_EVT_PARSE_FAILED,   // arg0: packet bytes, arg1: header bytes 0-3 (flags, sequence, type, ID)
+    DDP_EVT_PARSE_HEADER,   // arg0: data offset (header bytes 4-7), arg1: data length (bytes 8-9)
+};
+
+/**
+ * Get format string for a deferred log event (two unsigned long arguments)
+ */
+inline const char* ddpLogEventFormat(uint8_t event) {
+    switch (event) {
+        case DDP_EVT_ACK_PACKET:   return "[DDPico] ACK: Packet #%lu received (%lu bytes)\r\n";
+        case DDP_EVT_ACK_PERIOD:   return "[DDPico] ACK: %lu packets received in last %lu ms\r\n";
+        case DDP_EVT_BUFFER_FULL:  return "[DDPico] WARN: Buffer full - packet dropped (%lu bytes)\r\n";
+        case DDP_EVT_BAD_DEST:     return "[DDPico] WARN: Invalid destination ID %lu - no such channel\r\n";
+        case DDP_EVT_OUT_OF_RANGE: return "[DDPico] WARN: Start pixel %lu >= LED count %lu\r\n";
+        case DDP_EVT_BAD_CONFIG:   return "[DDPico] WARN: Bad config command %lu (%lu bytes)\r\n";
+        case DDP_EVT_INCOMPLETE:   return "[DDPico] DEBUG: Channel %lu pushed with pixels missing (frame %lu)\r\n";
+        case DDP_EVT_PARSE_FAILED: return "[DDPico] WARN: Parse failed - %lu bytes, flags/seq/type/ID %08lX\r\n";
+        case DDP_EVT_PARSE_HEADER: return "[DDPico] WARN: Parse failed - offset %lu, data length %lu\r\n";
+        default:                   return "[DDPico] Event %lu %lu\r\n";
+    }
+}
+
+/**
+ * Lock-free ring of binary log records
+ * One producer core pushes fixed-size records, the output core pops and
+ * formats them when it has nothing better to do. Records are dropped (and
+ * counted) rather than ever blocking the producer.
+ */
+template<size_t SIZE>
+class DDPLogRing {
+    static_assert((SIZE & (SIZE - 1)) == 0, "DDPLogRing size must be a power of two");
+
+public:
+    struct Record {
+        uint8_t level;
+        uint8_t event;
+        uint32_t arg0;
+        uint32_t arg1;
+    };
+
+    DDPLogRing() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * Queue a record (producer only)
+     * @return false if the ring is full and the record was dropped
+     */
+    bool push(uint8_t level, uint8_t event, uint32_t arg0, uint32_t arg1) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= SIZE) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        Record& record = records[h & (SIZE - 1)];
+        record.level = level;
+        record.event = event;
+        record.arg0 = arg0;
+        record.arg1 = arg1;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Take the oldest record (consumer only)
+     * @return false if the ring is empty
+     */
+    bool pop(Record& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = records[t & (SIZE - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Get number of records dropped because the ring was full
+     * Safe to read from either core.
+     */
+    uint32_t getDropped() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    Record records[SIZE];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<uint32_t> dropped;  // Written by the producer only
+};
@@ -1,11 +1,49 @@
 #pragma once
-#include <Arduino.h>
+#include <Platform.h>
 
 // DDP Protocol Constants
 #define DDP_HEADER_SIZE 10
+#define DDP_TIMECODE_SIZE 4  // Follows the header when DDP_FLAG_TIMECODE is set
+#define DDP_MAX_HEADER_SIZE (DDP_HEADER_SIZE + DDP_TIMECODE_SIZE)
 #define DDP_MAX_PACKET_SIZE 1440  // Max data per packet (480 RGB pixels)
+// Destination IDs. The DDP spec reserves 246 (JSON control), 250 (JSON
+// config), 251 (JSON status), 254 (DMX transit) and 255 (all devices), and
+// leaves 2-249 to outputs; the binary commands of this controller use IDs
+// the spec leaves unassigned, so a standard sender writing JSON to 250 is
+// never taken for one.
 #define DDP_ID_DEFAULT 1
 #define DDP_ID_BROADCAST 0
+#define DDP_ID_CONFIG 252  // Binary config commands (below)
+#define DDP_ID_STATUS 253  // Binary status query (DDP_FLAG_QUERY)
+
+// Config commands (first payload byte of a packet to DDP_ID_CONFIG)
+// DDP_CONFIG_LUT:       [cmd][channel][element mask][256 table entries]
+// DDP_CONFIG_LUT_RESET: [cmd][channel]
+// DDP_CONFIG_TIME_SYNC: [cmd][0][host timecode, 32-bit big-endian]
+// channel is 1-based like destination IDs, 0 = all channels;
+// element mask bits 0-3 select R, G, B, W
+#define DDP_CONFIG_LUT       0x01
+#define DDP_CONFIG_LUT_RESET 0x02
+#define DDP_CONFIG_TIME_SYNC 0x03
+
+// Status reply (payload of the reply to a packet with DDP_FLAG_QUERY sent
+// to DDP_ID_STATUS). The reply header has DDP_FLAG_VER1 | DDP_FLAG_REPLY,
+// the query's sequence number and DDP_ID_STATUS; multi-byte fields
+// big-endian:
+//   0     version (DDP_STATUS_VERSION)
+//   1     channel count
+//   2     mapping mode (DDP_MAPPING_*)
+//   3     output engine (DDP_OUTPUT_*; parallel only if it started)
+//   4-7   packets received
+//   8-11  packets processed
+//   12-15 packets dropped
+//   16-19 frames shown
+//   20-21 packet queue usage in 0.1%
+//   22-23 frame rate in 0.1 fps
+//   24+   per channel, 4 bytes: pin, bytes per pixel, LED count (16-bit)
+#define DDP_STATUS_VERSION       1
+#define DDP_STATUS_HEADER_SIZE   24
+#define DDP_STATUS_CHANNEL_SIZE  4
 
 // DDP Flags (byte 0)
 #define DDP_FLAG_VER_MASK   0xC0  // Version mask (bits 7-6)
@@ -16,19 +54,34 @@
 #define DDP_FLAG_QUERY      0x02  // Query packet (bit 1)
 #define DDP_FLAG_PUSH       0x01  // Push to display (bit 0)
 
-// DDP Data Types (byte 2)
-#define DDP_TYPE_RGB        0x01  // RGB data
+// DDP Data Types (byte 2): C R TTT SSS
+// C = customer defined, TTT = pixel type, SSS = bits per element
+#define DDP_TYPE_CUSTOM     0x80  // Customer defined type (bit 7)
+#define DDP_TYPE_PIXEL_MASK 0x38  // Pixel type (bits 5-3)
+#define DDP_TYPE_SIZE_MASK  0x07  // Bits per element (bits 2-0)
+#define DDP_PIXEL_RGB       0x08  // TTT = 1
+#define DDP_PIXEL_RGBW      0x18  // TTT = 3
+#define DDP_SIZE_8          0x03  // SSS = 3
+#define DDP_SIZE_16         0x04  // SSS = 4
+
+#define DDP_TYPE_RGB        0x01  // RGB data (legacy value, 8 bits per element)
+#define DDP_TYPE_RGB8       (DDP_PIXEL_RGB | DDP_SIZE_8)     // 0x0B
+#define DDP_TYPE_RGB16      (DDP_PIXEL_RGB | DDP_SIZE_16)    // 0x0C
+#define DDP_TYPE_RGBW8      (DDP_PIXEL_RGBW | DDP_SIZE_8)    // 0x1B
+#define DDP_TYPE_RGBW16     (DDP_PIXEL_RGBW | DDP_SIZE_16)   // 0x1C
 
 /**
- * DDP Packet Structure (10-byte header)
+ * DDP Packet Structure (10-byte header, 14 with timecode)
  *
  * Byte 0: Flags
  * Byte 1: Sequence (0-15) + reserved
- * Byte 2: Data type (0x00 or 0x01 = RGB)
+ * Byte 2: Data type (0x00 or 0x01 = RGB, else C R TTT SSS: RGB/RGBW, 8/16 bits)
  * Byte 3: Destination ID
  * Bytes 4-7: Data offset (32-bit big-endian)
  * Bytes 8-9: Data length (16-bit big-endian)
- * Bytes 10+: Pixel data
+ * Bytes 10-13: Timecode (32-bit big-endian), only if DDP_FLAG_TIMECODE is set:
+ *              16.16 seconds, the middle 32 bits of an NTP timestamp
+ * Bytes 10+ (14+ with timecode): Pixel data
  */
 struct DDPPacket {
     uint8_t flags;
@@ -37,20 +90,39 @@ struct DDPPacket {
     uint8_t destId;
     uint32_t dataOffset;    // 32-bit offset (bytes 4-7)
     uint16_t dataLength;    // 16-bit length (bytes 8-9)
+    uint32_t timecode;      // Presentation time (bytes 10-13), 0 if not present
     const uint8_t* data;
+    uint8_t elements;       // Elements per pixel (3 = RGB, 4 = RGBW), 0 if unsupported
+    uint8_t elementBytes;   // Bytes per element (1 or 2, big-endian)
     
     bool isValid() const {
         // Check version is 1 (bits 7-6 should be 01 = 0x40)
-        // Accept dataType 0x00 (undefined, used by xLights) or 0x01 (RGB)
+        // Data type must be one we can decode (see DDPProtocol::decodeDataType)
+        // Queries may come without data
         return ((flags & DDP_FLAG_VER_MASK) == DDP_FLAG_VER1) &&
-               (dataType == 0x00 || dataType == DDP_TYPE_RGB) &&
-               dataLength > 0 &&
+               elements != 0 &&
+               (dataLength > 0 || isQuery()) &&
                dataLength <= DDP_MAX_PACKET_SIZE;
     }
     
+    /**
+     * Get bytes per pixel of the packet's data type
+     */
+    uint8_t getPixelBytes() const {
+        return elements * elementBytes;
+    }
+    
     bool shouldPush() const {
         return flags & DDP_FLAG_PUSH;
     }
+    
+    bool hasTimecode() const {
+        return flags & DDP_FLAG_TIMECODE;
+    }
+    
+    bool isQuery() const {
+        return flags & DDP_FLAG_QUERY;
+    }
 };
 
 /**
@@ -76,6 +148,7 @@ public:
         packet.sequence = buffer[1] & 0x0F;
         packet.dataType = buffer[2];
         packet.destId = buffer[3];
+        decodeDataType(packet.dataType, packet.elements, packet.elementBytes);
         
         // Parse 32-bit data offset (bytes 4-7, big-endian)
         packet.dataOffset = ((uint32_t)buffer[4] << 24) |
@@ -91,13 +164,27 @@ public:
             return false;
         }
         
+        // Optional timecode moves the data back by 4 bytes
+        size_t headerSize = DDP_HEADER_SIZE;
+        packet.timecode = 0;
+        if (packet.hasTimecode()) {
+            if (length < DDP_MAX_HEADER_SIZE) {
+                return false;
+            }
+            packet.timecode = ((uint32_t)buffer[10] << 24) |
+                              ((uint32_t)buffer[11] << 16) |
+                              ((uint32_t)buffer[12] << 8) |
+                              buffer[13];
+            headerSize = DDP_MAX_HEADER_SIZE;
+        }
+        
         // Check if we have enough data
-        if (length < DDP_HEADER_SIZE + packet.dataLength) {
+        if (length < headerSize + packet.dataLength) {
             return false;
         }
         
-        // Point to pixel data (starts at byte 10)
-        packet.data = buffer + 10;
+        // Point to pixel data (starts at byte 10, or 14 after a timecode)
+        packet.data = buffer + headerSize;
         
         return true;
     }
@@ -106,6 +193,61 @@ public:
      * Calculate number of pixels in packet
      */
     static uint16_t getPixelCount(const DDPPacket& packet) {
-        return packet.dataLength / 3;  // RGB = 3 bytes per pixel
+        return packet.dataLength / packet.getPixelBytes();
+    }
+    
+    /**
+     * Write a 16-bit big-endian value
+     * @return Position after the value
+     */
+    static uint8_t* putBE16(uint8_t* p, uint16_t value) {
+        p[0] = value >> 8;
+        p[1] = value;
+        return p + 2;
+    }
+    
+    /**
+     * Write a 32-bit big-endian value
+     * @return Position after the value
+     */
+    static uint8_t* putBE32(uint8_t* p, uint32_t value) {
+        p[0] = value >> 24;
+        p[1] = value >> 16;
+        p[2] = value >> 8;
+        p[3] = value;
+        return p + 4;
+    }
+    
+    /**
+     * Decode the data type byte
+     * 0x00 (undefined, used by xLights) and the legacy 0x01 mean 8-bit RGB.
+     * @param type Data type byte
+     * @param elements Output elements per pixel, 0 if the type is unsupported
+     * @param elementBytes Output bytes per element
+     * @return true if the type is supported
+     */
+    static bool decodeDataType(uint8_t type, uint8_t& elements, uint8_t& elementBytes) {
+        elements = 0;
+        elementBytes = 1;
+        
+        if (type == 0x00 || type == DDP_TYPE_RGB) {
+            elements = 3;
+            return true;
+        }
+        if (type & DDP_TYPE_CUSTOM) {
+            return false;
+        }
+        
+        switch (type & DDP_TYPE_SIZE_MASK) {
+            case DDP_SIZE_8:  elementBytes = 1; break;
+            case DDP_SIZE_16: elementBytes = 2; break;
+            default: return false;
+        }
+        switch (type & DDP_TYPE_PIXEL_MASK) {
+            case DDP_PIXEL_RGB:  elements = 3; break;
+            case DDP_PIXEL_RGBW: elements = 4; break;
+            default: return false;
+        }
+        return true;
     }
 };
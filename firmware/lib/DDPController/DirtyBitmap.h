@@ -0,0 +1,112 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * One bit per pixel marking what has been written since the last push
+ * Fragments mark the pixel range they cover; on push the marked runs are
+ * the only part of the frame that needs copying, and a bitmap that is not
+ * full tells that the frame was pushed with fragments missing.
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+class DirtyBitmap {
+public:
+    DirtyBitmap() : words(nullptr), bits(0), dirty(false) {}
+
+    /**
+     * Allocate the bitmap, all clear
+     * @param count Number of pixels
+     */
+    void allocate(uint16_t count) {
+        bits = count;
+        words = new uint32_t[wordCount()]();
+        dirty = false;
+    }
+
+    /**
+     * Mark a range of pixels as written
+     * @param start First pixel
+     * @param count Number of pixels, already clipped to the bitmap
+     */
+    void mark(uint16_t start, uint16_t count) {
+        uint32_t first = start;
+        uint32_t end = (uint32_t)start + count;
+        while (first < end) {
+            uint32_t bit = first & 31;
+            uint32_t n = (end - first < 32 - bit) ? end - first : 32 - bit;
+            uint32_t mask = (n == 32) ? 0xFFFFFFFF : ((1u << n) - 1) << bit;
+            words[first >> 5] |= mask;
+            first += n;
+        }
+        dirty |= count != 0;
+    }
+
+    /**
+     * Check if any pixel has been marked
+     */
+    bool any() const {
+        return dirty;
+    }
+
+    /**
+     * Check if every pixel has been marked
+     */
+    bool full() const {
+        size_t whole = bits >> 5;
+        for (size_t i = 0; i < whole; i++) {
+            if (words[i] != 0xFFFFFFFF) {
+                return false;
+            }
+        }
+        uint32_t rest = bits & 31;
+        return rest == 0 || words[whole] == (1u << rest) - 1;
+    }
+
+    /**
+     * Find the next run of marked pixels
+     * Loop with: for (uint16_t pos = 0, n; map.nextRun(pos, n); pos += n)
+     * @param start In: first pixel to look at, out: first pixel of the run
+     * @param count Out: length of the run
+     * @return false if no marked pixel is left
+     */
+    bool nextRun(uint16_t& start, uint16_t& count) const {
+        uint32_t i = start;
+        while (i < bits && !test(i)) {
+            i += ((i & 31) == 0 && words[i >> 5] == 0) ? 32 : 1;
+        }
+        if (i >= bits) {
+            return false;
+        }
+        uint32_t j = i;
+        while (j < bits && test(j)) {
+            j += ((j & 31) == 0 && words[j >> 5] == 0xFFFFFFFF) ? 32 : 1;
+        }
+        start = i;
+        count = ((j < bits) ? j : bits) - i;
+        return true;
+    }
+
+    /**
+     * Clear all marks
+     */
+    void clear() {
+        memset(words, 0, wordCount() * sizeof(uint32_t));
+        dirty = false;
+    }
+
+private:
+    size_t wordCount() const {
+        return (bits + 31) / 32;
+    }
+
+    bool test(uint32_t i) const {
+        return words[i >> 5] & (1u << (i & 31));
+    }
+
+    uint32_t* words;
+    uint16_t bits;
+    bool dirty;
+};
@@ -0,0 +1,223 @@
+#pragma once
+#include <Platform.h>
+#include <atomic>
+#include "DDPProtocol.h"
+#include "Profile.h"
+
+// One full DDP packet (header with timecode + 480 RGB pixels), rounded up to a word
+#define DDP_POOL_SLOT_SIZE ((DDP_MAX_HEADER_SIZE + DDP_MAX_PACKET_SIZE + 3) & ~3)
+
+/**
+ * Lock-free fixed-slot packet pool for dual-core communication
+ * Core 1 claims a slot, decodes a frame into it and commits it (producer)
+ * Core 0 peeks the oldest slot, processes it in place and releases it (consumer)
+ *
+ * Every packet gets its own word-aligned SLOT_SIZE slot, so payloads are
+ * always contiguous and never straddle the end of a buffer. Slot lengths
+ * live in a separate descriptor queue; a corrupt descriptor costs only its
+ * own slot instead of flushing everything that is queued behind it.
+ *
+ * Head and tail count slots, are written by one core each, and are
+ * published with release stores / observed with acquire loads exactly as
+ * in SPSCQueue. SLOT_COUNT must be a power of two.
+ */
+template<size_t SLOT_COUNT, size_t SLOT_SIZE = DDP_POOL_SLOT_SIZE>
+class PacketPool {
+    static_assert(SLOT_COUNT >= 2 && (SLOT_COUNT & (SLOT_COUNT - 1)) == 0,
+                  "PacketPool slot count must be a power of two");
+    static_assert(SLOT_SIZE % 4 == 0 && SLOT_SIZE <= 0xFFFF,
+                  "PacketPool slot size must be word aligned and fit a 16-bit length");
+
+public:
+    // Largest record a single slot can hold
+    static constexpr size_t MAX_RECORD_SIZE = SLOT_SIZE;
+
+    PacketPool() : head(0), tail(0), completedAt(0) {}
+
+    /**
+     * Reserve the next free slot (producer only)
+     * The slot stays private to the producer until commit().
+     * @param length Maximum payload length that will be written
+     * @return Pointer to slot storage, nullptr if pool full or length too large
+     */
+    uint8_t* claim(size_t length) {
+        if (length == 0 || length > SLOT_SIZE) {
+            return nullptr;
+        }
+
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= SLOT_COUNT) {
+            return nullptr;  // Pool full
+        }
+
+        return slots[h & MASK].data;
+    }
+
+    /**
+     * Publish the slot returned by the last claim() (producer only)
+     * @param length Bytes actually written, at most SLOT_SIZE
+     */
+    void commit(size_t length) {
+        size_t h = head.load(std::memory_order_relaxed);
+        descriptors[h & MASK].length = length;
+#if DDP_PROFILE
+        descriptors[h & MASK].completedAt = completedAt;
+        descriptors[h & MASK].queuedAt = DDP_PROFILE_NOW();
+#endif
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    /**
+     * Note when the frame for the next commit was complete (producer only, DDP_PROFILE)
+     * @param time DDP_PROFILE_NOW() stamp
+     */
+    void markFrameComplete(uint32_t time) {
+        completedAt = time;
+    }
+
+    /**
+     * Get the stamps of the packet returned by the last peek() (consumer only)
+     * Both are 0 unless DDP_PROFILE is enabled.
+     * @param completed When its COBS frame was complete
+     * @param queued When it was committed
+     */
+    void peekTimes(uint32_t& completed, uint32_t& queued) const {
+#if DDP_PROFILE
+        const Descriptor& desc = descriptors[tail.load(std::memory_order_relaxed) & MASK];
+        completed = desc.completedAt;
+        queued = desc.queuedAt;
+#else
+        completed = queued = 0;
+#endif
+    }
+
+    /**
+     * Access the oldest packet in place (consumer only)
+     * The slot stays valid until release().
+     * @param length Output packet length
+     * @return Pointer to slot data, nullptr if empty
+     */
+    const uint8_t* peek(size_t& length) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+
+        while (t != h) {
+            const Descriptor& desc = descriptors[t & MASK];
+            if (desc.length > 0 && desc.length <= SLOT_SIZE) {
+                length = desc.length;
+                return slots[t & MASK].data;
+            }
+
+            // Corrupted descriptor, drop just this slot
+            tail.store(++t, std::memory_order_release);
+        }
+
+        length = 0;
+        return nullptr;
+    }
+
+    /**
+     * Free the slot returned by the last peek() (consumer only)
+     */
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * Write data to pool (producer only)
+     * @param data Pointer to data
+     * @param length Data length
+     * @return true if successful, false if pool full
+     */
+    bool write(const uint8_t* data, size_t length) {
+        uint8_t* slot = claim(length);
+        if (!slot) {
+            return false;
+        }
+        memcpy(slot, data, length);
+        commit(length);
+        return true;
+    }
+
+    /**
+     * Read data from pool (consumer only)
+     * @param data Output buffer
+     * @param maxLength Maximum bytes to read
+     * @return Number of bytes read, 0 if empty
+     */
+    size_t read(uint8_t* data, size_t maxLength) {
+        size_t length;
+        const uint8_t* slot = peek(length);
+        if (!slot) {
+            return 0;
+        }
+        if (length > maxLength) {
+            // Packet does not fit the caller's buffer, skip just this one
+            release();
+            return 0;
+        }
+        memcpy(data, slot, length);
+        release();
+        return length;
+    }
+
+    /**
+     * Check if pool has packets available (consumer side)
+     */
+    bool available() const {
+        return head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Get free space in pool, in bytes of free slots
+     * Snapshot only; the other core may move its index right after
+     */
+    size_t availableSpace() const {
+        return (SLOT_COUNT - used()) * SLOT_SIZE;
+    }
+
+    /**
+     * Clear pool (consumer only)
+     * Drops every packet the producer has published so far
+     */
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /**
+     * Get pool usage statistics (percentage of slots in use)
+     */
+    float getUsagePercent() const {
+        return (used() * 100.0f) / SLOT_COUNT;
+    }
+
+private:
+    static constexpr size_t MASK = SLOT_COUNT - 1;
+
+    struct Slot {
+        alignas(4) uint8_t data[SLOT_SIZE];
+    };
+
+    struct Descriptor {
+        uint16_t length;
+#if DDP_PROFILE
+        uint32_t completedAt;
+        uint32_t queuedAt;
+#endif
+    };
+
+    size_t used() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return h - t;
+    }
+
+    Slot slots[SLOT_COUNT];
+    Descriptor descriptors[SLOT_COUNT];
+
+    // Producer and consumer slot counters; each is written by exactly one core
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    uint32_t completedAt;  // Producer side, copied into the next descriptor
+};
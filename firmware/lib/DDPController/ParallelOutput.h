@@ -0,0 +1,245 @@
+#pragma once
+#include <Platform.h>
+#include "BitPlane.h"
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/clocks.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/pio.h>
+#include <pico/time.h>
+
+// WS2812 reset (latch) time; newer parts need well over the 50us in old datasheets
+#define PARALLEL_OUTPUT_LATCH_US 300
+
+/**
+ * Parallel WS2812 output engine
+ * Drives up to 8 strips at once from one PIO state machine fed by DMA, so
+ * a refresh takes as long as the longest strip instead of the sum of all
+ * strips. Strip bytes are transposed into bit-planes (see BitPlane.h) and
+ * every bit time the state machine writes one halfword to a window of up
+ * to 16 consecutive GPIOs:
+ *
+ *   out x, 16            ; 1 cycle   next bit-plane, all lanes low
+ *   mov pins, !null [2]  ; 3 cycles  all lanes high
+ *   mov pins, x [3]      ; 4 cycles  lanes sending a 1 stay high
+ *   mov pins, null [1]   ; 2 cycles  all lanes low
+ *
+ * At 8 MHz that is 1.25us per bit with 375ns / 875ns high times. Only the
+ * lane pins are switched to the PIO, other GPIOs inside the window are
+ * left alone.
+ *
+ * show() is asynchronous: bit-planes are double buffered, so the next
+ * frame is encoded while DMA streams the previous one, and show() only
+ * waits if that transfer (plus the latch time) is still running when the
+ * next frame is ready. The DMA completion interrupt (DMA_IRQ_0) marks the
+ * transfer done; begin() must run on the core that calls show(). Only one
+ * instance may exist.
+ */
+class ParallelOutput {
+public:
+    static constexpr uint8_t MAX_LANES = 8;
+
+    ParallelOutput()
+        : laneCount(0), basePin(0), planeBytes(0), backPlanes(0),
+          pio(nullptr), sm(0), programOffset(0), dmaChannel(-1),
+          busy(false), latchUntil(0), shows(0), waits(0), waitMicros(0) {
+        planes[0] = nullptr;
+        planes[1] = nullptr;
+        instance = this;
+    }
+
+    ~ParallelOutput() {
+        delete[] planes[0];
+        delete[] planes[1];
+    }
+
+    /**
+     * Claim a state machine and DMA channel for the given pins
+     * @param lanePins GPIO of each lane
+     * @param lanes Number of lanes (max 8)
+     * @param maxBytes Longest strip in bytes
+     * @return false if the pins do not fit a 16 GPIO window or no PIO
+     *         resources are free; the caller should fall back to showing
+     *         strips one at a time
+     */
+    bool begin(const uint8_t* lanePins, uint8_t lanes, size_t maxBytes) {
+        if (lanes == 0 || lanes > MAX_LANES) {
+            return false;
+        }
+
+        uint8_t lowPin = 0xFF;
+        uint8_t highPin = 0;
+        uint32_t pinMask = 0;
+        for (uint8_t i = 0; i < lanes; i++) {
+            lowPin = min(lowPin, lanePins[i]);
+            highPin = max(highPin, lanePins[i]);
+            pins[i] = lanePins[i];
+        }
+        if (highPin - lowPin >= 16 || highPin >= 32) {
+            return false;
+        }
+
+        if (!pio_claim_free_sm_and_add_program(&program, &pio, &sm, &programOffset)) {
+            return false;
+        }
+
+        laneCount = lanes;
+        basePin = lowPin;
+        BitPlane::buildPinMap(pins, laneCount, basePin, pinMap);
+
+        planeBytes = maxBytes;
+        planes[0] = new uint32_t[planeBytes * BitPlane::WORDS_PER_BYTE];
+        planes[1] = new uint32_t[planeBytes * BitPlane::WORDS_PER_BYTE];
+
+        for (uint8_t i = 0; i < laneCount; i++) {
+            pio_gpio_init(pio, pins[i]);
+            pinMask |= 1u << pins[i];
+        }
+        pio_sm_set_pins_with_mask(pio, sm, 0, pinMask);
+        pio_sm_set_pindirs_with_mask(pio, sm, pinMask, pinMask);
+
+        pio_sm_config config = pio_get_default_sm_config();
+        sm_config_set_wrap(&config, programOffset, programOffset + program.length - 1);
+        sm_config_set_out_pins(&config, basePin, highPin - basePin + 1);
+        sm_config_set_out_shift(&config, true, true, 32);
+        sm_config_set_fifo_join(&config, PIO_FIFO_JOIN_TX);
+        sm_config_set_clkdiv(&config, clock_get_hz(clk_sys) / 8000000.0f);
+        pio_sm_init(pio, sm, programOffset, &config);
+        pio_sm_set_enabled(pio, sm, true);
+
+        dmaChannel = dma_claim_unused_channel(true);
+        dma_channel_config dmaConfig = dma_channel_get_default_config(dmaChannel);
+        channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_32);
+        channel_config_set_read_increment(&dmaConfig, true);
+        channel_config_set_write_increment(&dmaConfig, false);
+        channel_config_set_dreq(&dmaConfig, pio_get_dreq(pio, sm, true));
+        dma_channel_configure(dmaChannel, &dmaConfig, &pio->txf[sm], planes[0], 0, false);
+
+        dma_channel_set_irq0_enabled(dmaChannel, true);
+        irq_add_shared_handler(DMA_IRQ_0, dmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+
+        return true;
+    }
+
+    /**
+     * Check if begin() succeeded
+     */
+    bool isActive() const {
+        return dmaChannel >= 0;
+    }
+
+    /**
+     * Start output of all lanes at once
+     * The lane buffers are encoded before this returns and may be changed
+     * straight away; the strips are sent in the background.
+     * @param lanes Bytes of each lane in wire order (e.g. GRB)
+     * @param lengths Length of each lane in bytes
+     */
+    void show(const uint8_t* const lanes[], const size_t lengths[]) {
+        size_t length = 0;
+        for (uint8_t i = 0; i < laneCount; i++) {
+            length = max(length, lengths[i]);
+        }
+        length = min(length, planeBytes);
+
+        // Encoding overlaps the transfer and latch time of the previous frame
+        uint32_t* buffer = planes[backPlanes];
+        BitPlane::encode(lanes, lengths, laneCount, length, pinMap, buffer);
+
+        if (isBusy()) {
+            uint64_t start = time_us_64();
+            waitIdle();
+            waits++;
+            waitMicros += time_us_64() - start;
+        }
+
+        busy = true;
+        shows++;
+        dma_channel_transfer_from_buffer_now(dmaChannel, buffer, length * BitPlane::WORDS_PER_BYTE);
+        backPlanes ^= 1;
+    }
+
+    /**
+     * Check if the previous frame is still being sent or latched
+     */
+    bool isBusy() const {
+        return busy || time_us_64() < latchUntil;
+    }
+
+    /**
+     * Wait until the previous frame has been sent and latched
+     */
+    void waitIdle() const {
+        while (isBusy()) {
+            tight_loop_contents();
+        }
+    }
+
+    /**
+     * Get output statistics
+     * @param started Frames sent
+     * @param waited Frames that had to wait for the previous one
+     * @param waitedMicros Total time spent waiting
+     */
+    void getStats(uint32_t& started, uint32_t& waited, uint32_t& waitedMicros) const {
+        started = shows;
+        waited = waits;
+        waitedMicros = waitMicros;
+    }
+
+private:
+    // Time to shift out what is left when DMA completes: up to 8 words in
+    // the joined TX FIFO plus one in the shift register, 2 bits of 1.25us each
+    static constexpr uint32_t FIFO_DRAIN_US = (8 + 1) * 2 * 5 / 4 + 1;
+
+    static void dmaIrqHandler() {
+        ParallelOutput* self = instance;
+        if (self && dma_channel_get_irq0_status(self->dmaChannel)) {
+            dma_channel_acknowledge_irq0(self->dmaChannel);
+            // Last bits are still leaving the FIFO; latch starts after them
+            self->latchUntil = time_us_64() + FIFO_DRAIN_US + PARALLEL_OUTPUT_LATCH_US;
+            self->busy = false;
+        }
+    }
+
+    static inline ParallelOutput* instance = nullptr;
+
+    static constexpr uint16_t programInstructions[4] = {
+        0x6030,  // out x, 16
+        0xA20B,  // mov pins, !null [2]
+        0xA301,  // mov pins, x [3]
+        0xA103,  // mov pins, null [1]
+    };
+
+    static constexpr pio_program_t program = {
+        .instructions = programInstructions,
+        .length = 4,
+        .origin = -1,
+    };
+
+    uint8_t pins[MAX_LANES];
+    uint8_t laneCount;
+    uint8_t basePin;
+    uint16_t pinMap[256];
+    size_t planeBytes;
+
+    // Bit-plane buffers: one being sent, one being encoded
+    uint32_t* planes[2];
+    uint8_t backPlanes;
+
+    PIO pio;
+    uint sm;
+    uint programOffset;
+    int dmaChannel;
+
+    // Written by the DMA interrupt
+    volatile bool busy;
+    volatile uint64_t latchUntil;
+
+    uint32_t shows;
+    uint32_t waits;
+    uint32_t waitMicros;
+};
+#endif
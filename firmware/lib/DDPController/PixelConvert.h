@@ -0,0 +1,130 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "ColorCorrection.h"
+
+/**
+ * Pixel conversion kernels from DDP data into channel frames
+ * Channel frames hold one 8.8 fixed point level per element (255.0 =
+ * 0xFF00), in R, G, B[, W] order, with as many elements per pixel as the
+ * strip has. DDP data may be RGB or RGBW with 8 or 16 bits per element
+ * (big-endian). Each input/output layout gets its own template instance,
+ * so the per-pixel loop has no format branches.
+ *
+ * - Every element goes through its color correction table; 16-bit
+ *   elements interpolate between entries so their extra bits survive.
+ * - RGBW data sent to an RGB strip adds white into each color (saturating).
+ * - RGB data sent to an RGBW strip leaves white off.
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+class PixelConvert {
+public:
+    /**
+     * Convert pixels into a channel frame
+     * @param frame Frame position of the first pixel
+     * @param frameElements Elements per frame pixel (3 or 4)
+     * @param data DDP pixel data
+     * @param dataElements Elements per DDP pixel (3 or 4)
+     * @param elementBytes Bytes per DDP element (1 or 2)
+     * @param count Number of pixels
+     * @param lut Color correction tables
+     * @return Change in the number of lit pixels
+     */
+    static int32_t convert(uint16_t* frame, uint8_t frameElements, const uint8_t* data,
+                           uint8_t dataElements, uint8_t elementBytes, uint16_t count,
+                           const ColorLUT& lut) {
+        bool wide = elementBytes == 2;
+        if (dataElements == 3) {
+            if (frameElements == 3) {
+                return wide ? ingest<3, 2, 3>(frame, data, count, lut)
+                            : ingest<3, 1, 3>(frame, data, count, lut);
+            }
+            return wide ? ingest<3, 2, 4>(frame, data, count, lut)
+                        : ingest<3, 1, 4>(frame, data, count, lut);
+        }
+        if (frameElements == 3) {
+            return wide ? ingest<4, 2, 3>(frame, data, count, lut)
+                        : ingest<4, 1, 3>(frame, data, count, lut);
+        }
+        return wide ? ingest<4, 2, 4>(frame, data, count, lut)
+                    : ingest<4, 1, 4>(frame, data, count, lut);
+    }
+
+    /**
+     * Count lit pixels in a run of frame pixels
+     * @param frame First pixel of the run
+     * @param frameElements Elements per frame pixel (3 or 4)
+     * @param count Number of pixels
+     * @return Pixels with any element above zero
+     */
+    static int32_t countLit(const uint16_t* frame, uint8_t frameElements, uint16_t count) {
+        int32_t lit = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t any = 0;
+            for (uint8_t c = 0; c < frameElements; c++) {
+                any |= frame[c];
+            }
+            lit += any != 0;
+            frame += frameElements;
+        }
+        return lit;
+    }
+
+    /**
+     * Look up a 16-bit element, interpolating between table entries
+     * @param table Color correction table
+     * @param value 16-bit element (0xFFFF = full)
+     * @return 8.8 fixed point level
+     */
+    static uint16_t lookup16(const uint16_t* table, uint16_t value) {
+        // Rescale to 8.8 so the integer part indexes the table: 0xFFFF -> 0xFF00
+        uint16_t x = value - (value >> 8);
+        uint8_t index = x >> 8;
+        uint8_t fraction = x & 0xFF;
+        if (fraction == 0) {
+            return table[index];
+        }
+        int32_t step = (int32_t)table[index + 1] - table[index];
+        return table[index] + ((step * fraction) >> 8);
+    }
+
+private:
+    template<uint8_t IN, uint8_t BYTES, uint8_t OUT>
+    static int32_t ingest(uint16_t* frame, const uint8_t* data, uint16_t count, const ColorLUT& lut) {
+        int32_t litDelta = 0;
+
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t px[4];
+            for (uint8_t c = 0; c < IN; c++) {
+                if (BYTES == 2) {
+                    px[c] = lookup16(lut.table[c], ((uint16_t)data[2 * c] << 8) | data[2 * c + 1]);
+                } else {
+                    px[c] = lut.table[c][data[c]];
+                }
+            }
+            if (IN == 3) {
+                px[3] = 0;
+            } else if (OUT == 3) {
+                for (uint8_t c = 0; c < 3; c++) {
+                    uint32_t v = px[c] + px[3];
+                    px[c] = (v > 0xFF00) ? 0xFF00 : v;
+                }
+            }
+
+            uint16_t was = 0;
+            uint16_t now = 0;
+            for (uint8_t c = 0; c < OUT; c++) {
+                was |= frame[c];
+                now |= px[c];
+                frame[c] = px[c];
+            }
+            litDelta += (int32_t)(now != 0) - (int32_t)(was != 0);
+
+            data += IN * BYTES;
+            frame += OUT;
+        }
+        return litDelta;
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Host clock for scheduled presentation of DDP frames
+ * DDP timecodes are the middle 32 bits of an NTP timestamp: 16 bits of
+ * seconds and 16 bits of fraction (1/65536 s), wrapping every 18 hours.
+ * The host sends its current timecode in a DDP_CONFIG_TIME_SYNC packet;
+ * the clock then extrapolates host time from the local microsecond
+ * counter, and frames pushed with a timecode are shown when host time
+ * reaches it. Controllers synced to the same host show in lockstep, and
+ * link jitter shorter than the lead time is absorbed.
+ *
+ * Local time is a 32-bit microsecond counter, so the host should sync at
+ * least every hour (every few seconds keeps crystal drift negligible).
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+class PresentationClock {
+public:
+    PresentationClock() : synced(false), baseTimecode(0), baseMicros(0) {}
+
+    /**
+     * Set the host time
+     * @param timecode Host timecode now
+     * @param nowMicros Local microseconds now
+     */
+    void sync(uint32_t timecode, uint32_t nowMicros) {
+        baseTimecode = timecode;
+        baseMicros = nowMicros;
+        synced = true;
+    }
+
+    /**
+     * Check if a sync has been received
+     */
+    bool isSynced() const {
+        return synced;
+    }
+
+    /**
+     * Get the host timecode at a local time
+     * @param nowMicros Local microseconds
+     */
+    uint32_t now(uint32_t nowMicros) const {
+        uint64_t elapsed = (uint32_t)(nowMicros - baseMicros);
+        return baseTimecode + (uint32_t)((elapsed << 16) / 1000000);
+    }
+
+    /**
+     * Get the time left until a timecode
+     * @param timecode Host timecode
+     * @param nowMicros Local microseconds now
+     * @return Microseconds until the timecode, negative if it has passed;
+     *         clamped to about +-35 minutes
+     */
+    int32_t microsUntil(uint32_t timecode, uint32_t nowMicros) const {
+        int32_t ticks = (int32_t)(timecode - now(nowMicros));
+        int64_t wait = ((int64_t)ticks * 1000000) >> 16;
+        if (wait > INT32_MAX) {
+            return INT32_MAX;
+        }
+        if (wait < INT32_MIN) {
+            return INT32_MIN;
+        }
+        return (int32_t)wait;
+    }
+
+private:
+    bool synced;
+    uint32_t baseTimecode;
+    uint32_t baseMicros;
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <Platform.h>
+#include "DDPProtocol.h"
+#include "Telemetry.h"
+
+// Per-stage latency instrumentation. Off by default; when off the profiler
+// is an empty class and every stamp is the constant 0, so the calls compile
+// away. Times come from the 1 MHz system timer, which both cores share, so
+// stages that cross from Core 1 to Core 0 are measured against one clock
+// (the Cortex-M cycle counters are per core and not in sync).
+#ifndef DDP_PROFILE
+#define DDP_PROFILE 0
+#endif
+
+#if DDP_PROFILE
+#define DDP_PROFILE_NOW() ((uint32_t)micros())
+#else
+#define DDP_PROFILE_NOW() ((uint32_t)0)
+#endif
+
+/**
+ * Latency distribution of one stage
+ * Min, max, running sum and a log2 histogram: bucket 0 counts 0us, bucket
+ * n counts [2^(n-1), 2^n) us and the last bucket everything above.
+ */
+struct LatencyStats {
+    static constexpr uint8_t BUCKETS = 16;
+    static constexpr size_t WIRE_SIZE = 6 + 4 * 4 + 4 * BUCKETS;
+
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t histogram[BUCKETS];
+
+    LatencyStats() : count(0), minUs(UINT32_MAX), maxUs(0), sumUs(0), histogram{} {}
+
+    void record(uint32_t us) {
+        count++;
+        sumUs += us;
+        if (us < minUs) {
+            minUs = us;
+        }
+        if (us > maxUs) {
+            maxUs = us;
+        }
+        uint8_t bucket = us ? 32 - __builtin_clz(us) : 0;
+        histogram[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+    }
+
+    /**
+     * Write the stage as a DDP_FRAME_PROFILE frame, big-endian:
+     *
+     *   0     type (DDP_FRAME_PROFILE)
+     *   1     version (DDP_TELEMETRY_VERSION)
+     *   2-3   frame length in bytes
+     *   4     stage (Profiler::Stage)
+     *   5     bucket count
+     *   6     samples
+     *   10    min us (0 without samples)
+     *   14    average us
+     *   18    max us
+     *   22    histogram, 4 bytes per bucket
+     *
+     * @param stage Stage index
+     * @param out Output, WIRE_SIZE bytes
+     * @return Bytes written
+     */
+    size_t serialize(uint8_t stage, uint8_t* out) const {
+        uint8_t* p = out;
+        *p++ = DDP_FRAME_PROFILE;
+        *p++ = DDP_TELEMETRY_VERSION;
+        p = DDPProtocol::putBE16(p, WIRE_SIZE);
+        *p++ = stage;
+        *p++ = BUCKETS;
+        p = DDPProtocol::putBE32(p, count);
+        p = DDPProtocol::putBE32(p, count ? minUs : 0);
+        p = DDPProtocol::putBE32(p, count ? (uint32_t)(sumUs / count) : 0);
+        p = DDPProtocol::putBE32(p, maxUs);
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            p = DDPProtocol::putBE32(p, histogram[i]);
+        }
+        return p - out;
+    }
+};
+
+/**
+ * Stage timing of the packet path, from COBS frame to light
+ * Packet stages are recorded per packet, frame stages once per shown frame.
+ * Core 0 records everything; Core 1's stamps travel with the packet in its
+ * pool descriptor.
+ */
+class Profiler {
+public:
+    enum Stage : uint8_t {
+        STAGE_QUEUE_WRITE,  // COBS frame complete -> committed to the packet queue
+        STAGE_QUEUE_WAIT,   // Committed -> read by Core 0
+        STAGE_PARSE,        // Read -> header parsed
+        STAGE_APPLY,        // Parsed -> converted into the back buffer
+        STAGE_PUSH_HOLD,    // Push applied -> frame committed (coalescing)
+        STAGE_RENDER,       // Front buffer copy, limiter scale, dither into strip buffers
+        STAGE_SHOW,         // Strip output call (encode and start DMA, or blocking show)
+        STAGE_END_TO_END,   // COBS frame of the push complete -> output call returned
+        STAGE_COUNT
+    };
+
+#if DDP_PROFILE
+    /**
+     * Record a stage from two stamps
+     * Skipped if a stamp is missing (0), e.g. a queue without timestamps.
+     */
+    void record(Stage stage, uint32_t start, uint32_t end) {
+        if (start && end) {
+            stages[stage].record(end - start);
+        }
+    }
+
+    const LatencyStats& get(Stage stage) const {
+        return stages[stage];
+    }
+
+private:
+    LatencyStats stages[STAGE_COUNT];
+#else
+    void record(Stage, uint32_t, uint32_t) {}
+#endif
+};
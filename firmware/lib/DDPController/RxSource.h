@@ -0,0 +1,281 @@
+#pragma once
+#include <Platform.h>
+
+/**
+ * Receive block source for Core 1
+ * Hands the COBS decoder whole blocks of received bytes instead of single
+ * bytes. Backends:
+ * - StreamRxSource: bulk reads from an Arduino Stream (USB CDC Serial)
+ * - UartDmaRxSource: hardware UART RX filling double-buffered DMA blocks
+ * - MemoryRxSource: replays a byte buffer, for running the pipeline off-board
+ *
+ * Usage from the receive loop:
+ *   size_t len = source.acquire(data);   // 0 if nothing is ready
+ *   ... decode len bytes ...
+ *   source.release();                    // block may now be reused
+ *   source.wait();                       // idle until more data may be ready
+ */
+class RxSource {
+public:
+    virtual ~RxSource() {}
+
+    /**
+     * Start receiving
+     * Called on the core that runs the receive loop, so any interrupts the
+     * backend needs are taken there.
+     */
+    virtual void begin() {}
+
+    /**
+     * Get the next block of received bytes
+     * @param data Output pointer to the block, valid until release()
+     * @return Block length, 0 if no data is ready
+     */
+    virtual size_t acquire(const uint8_t*& data) = 0;
+
+    /**
+     * Hand the block returned by the last acquire() back to the source
+     */
+    virtual void release() = 0;
+
+    /**
+     * Idle until more data may be ready
+     */
+    virtual void wait() {
+        platformIdle();
+    }
+
+    /**
+     * Get number of received bytes lost because blocks were not consumed in time
+     */
+    virtual uint32_t getOverrunBytes() const {
+        return 0;
+    }
+};
+
+/**
+ * Block source reading an Arduino Stream in bulk
+ * Pulls up to BLOCK_SIZE bytes per readBytes() call, bounded by available()
+ * so the read never waits on the stream timeout.
+ */
+template<size_t BLOCK_SIZE>
+class StreamRxSource : public RxSource {
+public:
+    StreamRxSource(Stream& stream) : stream(stream) {}
+
+    size_t acquire(const uint8_t*& data) override {
+        int pending = stream.available();
+        if (pending <= 0) {
+            return 0;
+        }
+        data = block;
+        return stream.readBytes(block, min((size_t)pending, BLOCK_SIZE));
+    }
+
+    void release() override {}
+
+private:
+    Stream& stream;
+    uint8_t block[BLOCK_SIZE];
+};
+
+/**
+ * Block source replaying bytes from memory
+ * Stands in for the serial link when driving the pipeline without a board;
+ * blocks are cut at blockSize to mimic USB packets or DMA blocks.
+ */
+class MemoryRxSource : public RxSource {
+public:
+    MemoryRxSource(const uint8_t* data = nullptr, size_t length = 0, size_t blockSize = 64)
+        : source(data), sourceLength(length), position(0), blockSize(blockSize), pendingLength(0) {}
+
+    /**
+     * Replace the bytes to replay and rewind
+     */
+    void load(const uint8_t* data, size_t length) {
+        source = data;
+        sourceLength = length;
+        position = 0;
+        pendingLength = 0;
+    }
+
+    size_t acquire(const uint8_t*& data) override {
+        pendingLength = min(blockSize, sourceLength - position);
+        data = source + position;
+        return pendingLength;
+    }
+
+    void release() override {
+        position += pendingLength;
+        pendingLength = 0;
+    }
+
+    /**
+     * Check if every byte has been handed out
+     */
+    bool done() const {
+        return position >= sourceLength;
+    }
+
+private:
+    const uint8_t* source;
+    size_t sourceLength;
+    size_t position;
+    size_t blockSize;
+    size_t pendingLength;
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+#include <hardware/uart.h>
+#include <pico/time.h>
+
+/**
+ * Block source driven by hardware UART RX and two chained DMA channels
+ * Each channel fills its own BLOCK_SIZE block and chains to the other, so
+ * reception never stops while a finished block is being decoded. The DMA
+ * completion interrupt re-arms the finished channel and signals an event,
+ * and wait() sleeps in __wfe() until then. A repeating timer also signals
+ * every FLUSH_US so the tail of a frame sitting in a partly filled block is
+ * not held back until the block fills.
+ *
+ * begin() must run on the receiving core so the DMA interrupt is taken
+ * there. Only one instance may exist.
+ */
+template<size_t BLOCK_SIZE, uint32_t FLUSH_US = 1000>
+class UartDmaRxSource : public RxSource {
+public:
+    UartDmaRxSource(uart_inst_t* uart, uint8_t rxPin, uint32_t baud)
+        : uart(uart), rxPin(rxPin), baud(baud),
+          blocksCompleted(0), blocksConsumed(0), consumedBytes(0),
+          pendingLength(0), pendingWholeBlock(false), overrunBytes(0) {
+        instance = this;
+    }
+
+    void begin() override {
+        uart_init(uart, baud);
+        gpio_set_function(rxPin, GPIO_FUNC_UART);
+        uart_set_fifo_enabled(uart, true);
+
+        for (int i = 0; i < 2; i++) {
+            channels[i] = dma_claim_unused_channel(true);
+        }
+
+        for (int i = 0; i < 2; i++) {
+            dma_channel_config config = dma_channel_get_default_config(channels[i]);
+            channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+            channel_config_set_read_increment(&config, false);
+            channel_config_set_write_increment(&config, true);
+            channel_config_set_dreq(&config, uart_get_dreq(uart, false));
+            channel_config_set_chain_to(&config, channels[i ^ 1]);
+            dma_channel_configure(channels[i], &config, blocks[i], &uart_get_hw(uart)->dr,
+                                  BLOCK_SIZE, false);
+            dma_channel_set_irq1_enabled(channels[i], true);
+        }
+
+        irq_add_shared_handler(DMA_IRQ_1, dmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+
+        add_repeating_timer_us(-(int64_t)FLUSH_US, flushTick, nullptr, &flushTimer);
+
+        dma_channel_start(channels[0]);
+    }
+
+    size_t acquire(const uint8_t*& data) override {
+        while (true) {
+            uint32_t completed = blocksCompleted;
+
+            if (completed - blocksConsumed >= 2) {
+                // Both blocks refilled before we got to them; the oldest one is
+                // being overwritten, skip to the newest complete block
+                overrunBytes += (completed - blocksConsumed - 1) * BLOCK_SIZE - consumedBytes;
+                blocksConsumed = completed - 1;
+                consumedBytes = 0;
+            }
+
+            uint32_t index = blocksConsumed & 1;
+            data = blocks[index] + consumedBytes;
+
+            if (completed != blocksConsumed) {
+                if (consumedBytes == BLOCK_SIZE) {
+                    // Handed out in full while it was still filling; move on
+                    // to the next block
+                    blocksConsumed++;
+                    consumedBytes = 0;
+                    continue;
+                }
+                // Whole block finished, hand out whatever is left of it
+                pendingWholeBlock = true;
+                pendingLength = BLOCK_SIZE - consumedBytes;
+                return pendingLength;
+            }
+
+            // Block still filling: hand out the bytes that have landed so far
+            uint32_t landed = BLOCK_SIZE - dma_channel_hw_addr(channels[index])->transfer_count;
+            pendingWholeBlock = false;
+            pendingLength = (landed > consumedBytes) ? landed - consumedBytes : 0;
+            return pendingLength;
+        }
+    }
+
+    void release() override {
+        if (pendingWholeBlock) {
+            blocksConsumed++;
+            consumedBytes = 0;
+        } else {
+            consumedBytes += pendingLength;
+        }
+        pendingLength = 0;
+        pendingWholeBlock = false;
+    }
+
+    void wait() override {
+        // Woken by the DMA completion interrupt or the flush timer
+        __wfe();
+    }
+
+    uint32_t getOverrunBytes() const override {
+        return overrunBytes;
+    }
+
+private:
+    static void dmaIrqHandler() {
+        UartDmaRxSource* self = instance;
+        for (int i = 0; i < 2; i++) {
+            if (dma_channel_get_irq1_status(self->channels[i])) {
+                dma_channel_acknowledge_irq1(self->channels[i]);
+                // Rewind for the next round; the transfer count reloads by itself
+                dma_channel_set_write_addr(self->channels[i], self->blocks[i], false);
+                self->blocksCompleted++;
+            }
+        }
+        __sev();
+    }
+
+    static bool flushTick(repeating_timer_t*) {
+        __sev();
+        return true;
+    }
+
+    static UartDmaRxSource* instance;
+
+    uart_inst_t* uart;
+    uint8_t rxPin;
+    uint32_t baud;
+    int channels[2];
+    repeating_timer_t flushTimer;
+    alignas(4) uint8_t blocks[2][BLOCK_SIZE];
+
+    volatile uint32_t blocksCompleted;  // Written by the DMA interrupt only
+    uint32_t blocksConsumed;
+    uint32_t consumedBytes;
+    size_t pendingLength;
+    bool pendingWholeBlock;
+    uint32_t overrunBytes;
+};
+
+template<size_t BLOCK_SIZE, uint32_t FLUSH_US>
+UartDmaRxSource<BLOCK_SIZE, FLUSH_US>* UartDmaRxSource<BLOCK_SIZE, FLUSH_US>::instance = nullptr;
+#endif
@@ -0,0 +1,221 @@
+#pragma once
+#include <Platform.h>
+#include <atomic>
+
+/**
+ * Lock-free Single-Producer/Single-Consumer packet queue for dual-core communication
+ * Core 1 writes decoded frames (producer)
+ * Core 0 reads and processes them (consumer)
+ *
+ * Records are a 2-byte big-endian length header followed by the payload,
+ * padded to 4 bytes. Records never wrap: when one does not fit before the
+ * end of the buffer the producer leaves a zero-length wrap marker and starts
+ * again at offset 0, so every payload is one contiguous, aligned span that
+ * can be decoded into and parsed in place.
+ *
+ * Head is only written by the producer and tail only by the consumer. Each
+ * side publishes its index with a release store and observes the other
+ * side's index with an acquire load, so record bytes are always visible
+ * before the index that covers them and neither core ever blocks the other.
+ *
+ * Indices run freely and are masked on access, so BUFFER_SIZE must be a
+ * power of two.
+ */
+template<size_t BUFFER_SIZE>
+class SPSCQueue {
+    static_assert(BUFFER_SIZE >= 8 && (BUFFER_SIZE & (BUFFER_SIZE - 1)) == 0,
+                  "SPSCQueue size must be a power of two");
+
+public:
+    // Largest record a single claim can hold
+    static constexpr size_t MAX_RECORD_SIZE = (BUFFER_SIZE - 4 < 0xFFFF) ? BUFFER_SIZE - 4 : 0xFFFF;
+
+    SPSCQueue() : head(0), tail(0), claimIndex(0), peekIndex(0), peekLength(0) {}
+
+    /**
+     * Reserve a contiguous slot for a record (producer only)
+     * The slot stays private to the producer until commit().
+     * @param length Maximum payload length that will be written
+     * @return Pointer to payload storage, nullptr if queue full
+     */
+    uint8_t* claim(size_t length) {
+        if (length == 0 || length > MAX_RECORD_SIZE) {
+            return nullptr;
+        }
+
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+
+        size_t required = recordSize(length);
+        size_t pos = h & MASK;
+        size_t skip = (BUFFER_SIZE - pos < required) ? BUFFER_SIZE - pos : 0;
+
+        if (required > BUFFER_SIZE || BUFFER_SIZE - (h - t) < skip + required) {
+            return nullptr;  // Queue full
+        }
+
+        if (skip) {
+            // Wrap marker; only becomes visible together with the record
+            buffer[pos] = 0;
+            buffer[pos + 1] = 0;
+        }
+
+        claimIndex = h + skip;
+        return &buffer[(claimIndex & MASK) + 2];
+    }
+
+    /**
+     * Publish the slot returned by the last claim() (producer only)
+     * @param length Bytes actually written, at most the claimed length
+     */
+    void commit(size_t length) {
+        size_t pos = claimIndex & MASK;
+        buffer[pos] = (length >> 8) & 0xFF;
+        buffer[pos + 1] = length & 0xFF;
+        head.store(claimIndex + recordSize(length), std::memory_order_release);
+    }
+
+    /**
+     * Access the oldest record in place (consumer only)
+     * The record stays valid until release().
+     * @param length Output payload length
+     * @return Pointer to payload, nullptr if empty
+     */
+    const uint8_t* peek(size_t& length) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+
+        while (h - t >= 4) {
+            size_t pos = t & MASK;
+            size_t recordLength = ((size_t)buffer[pos] << 8) | buffer[pos + 1];
+
+            if (recordLength == 0) {
+                // Wrap marker, next record starts at offset 0
+                t += BUFFER_SIZE - pos;
+                tail.store(t, std::memory_order_release);
+                continue;
+            }
+
+            size_t size = recordSize(recordLength);
+            if (size > h - t || pos + size > BUFFER_SIZE) {
+                // Corrupted record, discard everything published so far
+                tail.store(h, std::memory_order_release);
+                break;
+            }
+
+            peekIndex = t;
+            peekLength = recordLength;
+            length = recordLength;
+            return &buffer[pos + 2];
+        }
+
+        length = 0;
+        return nullptr;
+    }
+
+    /**
+     * Free the record returned by the last peek() (consumer only)
+     */
+    void release() {
+        tail.store(peekIndex + recordSize(peekLength), std::memory_order_release);
+        peekLength = 0;
+    }
+
+    /**
+     * Write data to queue (producer only)
+     * @param data Pointer to data
+     * @param length Data length
+     * @return true if successful, false if queue full
+     */
+    bool write(const uint8_t* data, size_t length) {
+        uint8_t* slot = claim(length);
+        if (!slot) {
+            return false;
+        }
+        memcpy(slot, data, length);
+        commit(length);
+        return true;
+    }
+
+    /**
+     * Read data from queue (consumer only)
+     * @param data Output buffer
+     * @param maxLength Maximum bytes to read
+     * @return Number of bytes read, 0 if empty
+     */
+    size_t read(uint8_t* data, size_t maxLength) {
+        size_t length;
+        const uint8_t* record = peek(length);
+        if (!record) {
+            return 0;
+        }
+        if (length > maxLength) {
+            // Record does not fit the caller's buffer, skip just this one
+            release();
+            return 0;
+        }
+        memcpy(data, record, length);
+        release();
+        return length;
+    }
+
+    /**
+     * Check if queue has data available (consumer side)
+     */
+    bool available() const {
+        return head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Get available space in queue
+     * Snapshot only; the other core may move its index right after
+     */
+    size_t availableSpace() const {
+        return BUFFER_SIZE - used();
+    }
+
+    /**
+     * Clear queue (consumer only)
+     * Drops every record the producer has published so far
+     */
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+        peekLength = 0;
+    }
+
+    /**
+     * Get queue usage statistics
+     */
+    float getUsagePercent() const {
+        return (used() * 100.0f) / BUFFER_SIZE;
+    }
+
+private:
+    static constexpr size_t MASK = BUFFER_SIZE - 1;
+
+    /**
+     * Header plus payload, padded so every record starts 4-byte aligned
+     */
+    static size_t recordSize(size_t length) {
+        return (length + 2 + 3) & ~(size_t)3;
+    }
+
+    size_t used() const {
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t h = head.load(std::memory_order_acquire);
+        return h - t;
+    }
+
+    alignas(4) uint8_t buffer[BUFFER_SIZE];
+
+    // Producer and consumer indices; each is written by exactly one core
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    // Producer-private
+    size_t claimIndex;
+
+    // Consumer-private
+    size_t peekIndex;
+    size_t peekLength;
+};
@@ -0,0 +1,141 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * DDP sequence number tracking
+ * DDP senders number packets 1-15 per destination and wrap back to 1
+ * (0 means the sender does not number packets). Counting how far each
+ * number is from the last one seen finds loss and reordering between the
+ * host and the controller without logging every packet:
+ *
+ *   distance 0      duplicate
+ *   distance 1      in order
+ *   distance 2-7    gap, (distance - 1) packets missing
+ *   distance 8-14   late: arrived after a newer packet
+ *
+ * A late packet that belongs to a frame which has already been pushed is
+ * stale; applying it would write old pixels into the frame being assembled.
+ * RESYNC_RUN late packets in a row that follow each other mean the sender
+ * jumped eight or more numbers ahead (a long loss or a restart) rather than
+ * a few packets being reordered, so tracking resynchronises on the last one.
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+class SequenceTracker {
+public:
+    static constexpr uint8_t RESYNC_RUN = 3;
+
+    enum Result : uint8_t {
+        SEQ_UNNUMBERED,  // Sequence 0, not tracked
+        SEQ_IN_ORDER,
+        SEQ_GAP,         // In order after one or more missing packets
+        SEQ_DUPLICATE,
+        SEQ_LATE,        // Out of order, frame not pushed yet
+        SEQ_STALE,       // Out of order, frame already pushed
+    };
+
+    struct Stats {
+        uint32_t gaps;        // Times one or more packets were missing
+        uint32_t missing;     // Packets missing across all gaps
+        uint32_t duplicates;
+        uint32_t late;        // Out-of-order packets, stale ones included
+        uint32_t stale;
+    };
+
+    SequenceTracker() : stats{} {
+        reset();
+    }
+
+    /**
+     * Forget the sequence state of every destination
+     */
+    void reset() {
+        for (size_t i = 0; i < 256; i++) {
+            last[i] = 0;
+            pushed[i] = 0;
+            lateLast[i] = 0;
+            lateRun[i] = 0;
+        }
+    }
+
+    /**
+     * Track a received packet
+     * @param destId Destination ID
+     * @param sequence Sequence number (0-15)
+     * @param push Packet carries the push flag
+     * @return Classification of the packet
+     */
+    Result track(uint8_t destId, uint8_t sequence, bool push) {
+        if (sequence == 0) {
+            return SEQ_UNNUMBERED;
+        }
+        uint8_t& previous = last[destId];
+        if (previous == 0) {
+            previous = sequence;
+            if (push) {
+                pushed[destId] = sequence;
+            }
+            return SEQ_IN_ORDER;
+        }
+
+        uint8_t ahead = distance(previous, sequence);
+        if (ahead == 0) {
+            stats.duplicates++;
+            return SEQ_DUPLICATE;
+        }
+        if (ahead >= 8) {
+            bool run = lateRun[destId] && distance(lateLast[destId], sequence) == 1;
+            lateRun[destId] = run ? lateRun[destId] + 1 : 1;
+            lateLast[destId] = sequence;
+        }
+        if (ahead >= 8 && lateRun[destId] < RESYNC_RUN) {
+            stats.late++;
+            // Not ahead of the last push: its frame has already been shown
+            uint8_t afterPush = pushed[destId] ? distance(pushed[destId], sequence) : 1;
+            if (afterPush == 0 || afterPush >= 8) {
+                stats.stale++;
+                return SEQ_STALE;
+            }
+            return SEQ_LATE;
+        }
+
+        if (ahead >= 8) {
+            // Resynchronised; the gap size is unknown
+            ahead = 2;
+        }
+        previous = sequence;
+        lateRun[destId] = 0;
+        if (push) {
+            pushed[destId] = sequence;
+        }
+        if (ahead > 1) {
+            stats.gaps++;
+            stats.missing += ahead - 1;
+            return SEQ_GAP;
+        }
+        return SEQ_IN_ORDER;
+    }
+
+    /**
+     * Get counters since startup
+     */
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    /**
+     * Steps from one sequence number to another, modulo 15 (1-15 wrap)
+     */
+    static uint8_t distance(uint8_t from, uint8_t to) {
+        return (to + 15 - from) % 15;
+    }
+
+    uint8_t last[256];    // Newest sequence per destination, 0 = none yet
+    uint8_t pushed[256];  // Sequence of the newest push per destination, 0 = none yet
+    uint8_t lateLast[256];  // Sequence of the newest late packet
+    uint8_t lateRun[256];   // Consecutive late packets that follow each other
+    Stats stats;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+/**
+ * Counters owned by Core 1 (serial receiver)
+ */
+struct RxCounters {
+    uint32_t packetsReceived;  // Frames committed to the packet queue
+    uint32_t dropsQueueFull;   // Packet queue full
+    uint32_t dropsCobs;        // COBS frame too long or truncated
+    uint32_t overrunBytes;     // Received bytes the RX source lost (RxSource::getOverrunBytes())
+};
+
+/**
+ * Counters owned by Core 0 (packet processing)
+ */
+struct ProcessCounters {
+    uint32_t packetsProcessed;  // Parsed and accepted (applied or answered)
+    uint32_t dropsParse;        // Header or length invalid
+    uint32_t dropsStale;        // Stale fragment (DDP_DROP_STALE)
+    uint32_t rejectedDest;      // No channel for the destination
+    uint32_t rejectedRange;     // Offset past the end of the channel
+    uint32_t rejectedConfig;    // Unknown or malformed config command
+};
+
+/**
+ * Block of statistics counters with a single writer
+ * Only the owning core changes the counters, so it needs no lock and no
+ * atomic read-modify-write (which Cortex-M0+ lacks). Readers on the other
+ * core take a seqlock snapshot: the writer makes the sequence odd while it
+ * updates, and a reader retries until it copied the block between two
+ * equal, even sequence values. Several counters changed in one update are
+ * therefore always seen together.
+ *
+ * Usage on the owning core:
+ *   stats.begin().dropsParse++;
+ *   stats.end();
+ *
+ * Plain C++ with no hardware dependencies, so it can be built and checked
+ * on the host.
+ */
+template<typename Counters>
+class CounterBlock {
+public:
+    CounterBlock() : sequence(0), counters{} {}
+
+    /**
+     * Start an update (owning core only)
+     * @return Counters to change; finish with end()
+     */
+    Counters& begin() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return counters;
+    }
+
+    /**
+     * Publish the update started by begin()
+     */
+    void end() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * Read the counters on the owning core
+     * Nothing else writes them, so no snapshot is needed.
+     */
+    const Counters& local() const {
+        return counters;
+    }
+
+    /**
+     * Copy the counters consistently from any core
+     */
+    Counters snapshot() const {
+        Counters copy;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(&copy, &counters, sizeof(Counters));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+    /**
+     * Zero the counters (owning core, or before it starts)
+     */
+    void reset() {
+        begin() = Counters{};
+        end();
+    }
+
+private:
+    std::atomic<uint32_t> sequence;
+    Counters counters;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <Platform.h>
+#include "DDPProtocol.h"
+
+// Binary frames sent to the host share the serial link with DDP replies;
+// the first byte tells them apart. DDP v1 packets start with a flags byte
+// in 0x40-0x7F, so frame types stay outside that range.
+#define DDP_FRAME_TELEMETRY 0x01
+#define DDP_FRAME_PROFILE   0x02  // One stage of DDP_PROFILE timing (see Profile.h)
+
+// Telemetry record layout version; bump when fields change. Fields are only
+// ever appended, so readers can take the fields they know from a newer
+// record and use the length to skip the rest.
+#define DDP_TELEMETRY_VERSION 4
+
+/**
+ * Periodic telemetry record
+ * Fixed layout, big-endian, sent as its own COBS frame (0x00 <COBS> 0x00):
+ *
+ *   0     type (DDP_FRAME_TELEMETRY)
+ *   1     version (DDP_TELEMETRY_VERSION)
+ *   2-3   record length in bytes
+ *   4     uptime in ms
+ *   8     packets received (Core 1)
+ *   12    packets processed
+ *   16    dropped: packet queue full
+ *   20    dropped: parse error
+ *   24    dropped: stale (DDP_DROP_STALE)
+ *   28    rejected: bad destination, out of range or bad config
+ *   32    frames shown
+ *   36    channels pushed incomplete
+ *   40    sequence gaps
+ *   44    packets missing in gaps
+ *   48    duplicate packets
+ *   52    late packets
+ *   56    frames scheduled by timecode
+ *   60    scheduled frames shown late
+ *   64    output frames started (parallel engine)
+ *   68    output frames that waited for the previous one
+ *   72    output wait time in us
+ *   76    commit and render time of the last frame in us
+ *   80-81 packet queue usage in 0.1%
+ *   82-83 frame rate in 0.1 fps
+ *   84    dropped: COBS frame too long or truncated      (version 2)
+ *   88    rejected: bad destination                      (version 2)
+ *   92    rejected: offset out of range                  (version 2)
+ *   96    rejected: bad config                           (version 2)
+ *   100   log records dropped, ring full (both cores)    (version 3)
+ *   104   received bytes lost to RX source overrun       (version 4)
+ */
+struct TelemetryRecord {
+    static constexpr size_t SIZE = 108;
+
+    uint32_t uptimeMs;
+    uint32_t packetsReceived;
+    uint32_t packetsProcessed;
+    uint32_t dropsQueueFull;
+    uint32_t dropsParse;
+    uint32_t dropsStale;
+    uint32_t packetsRejected;
+    uint32_t framesShown;
+    uint32_t framesIncomplete;
+    uint32_t sequenceGaps;
+    uint32_t sequenceMissing;
+    uint32_t sequenceDuplicates;
+    uint32_t sequenceLate;
+    uint32_t framesScheduled;
+    uint32_t framesLate;
+    uint32_t outputShows;
+    uint32_t outputWaits;
+    uint32_t outputWaitMicros;
+    uint32_t renderMicros;
+    uint16_t queueUsage;
+    uint16_t frameRate;
+    uint32_t dropsCobs;
+    uint32_t rejectedDest;
+    uint32_t rejectedRange;
+    uint32_t rejectedConfig;
+    uint32_t logDropped;
+    uint32_t rxOverrunBytes;
+
+    /**
+     * Write the record in wire layout
+     * @param out Output, SIZE bytes
+     * @return Bytes written
+     */
+    size_t serialize(uint8_t* out) const {
+        uint8_t* p = out;
+        *p++ = DDP_FRAME_TELEMETRY;
+        *p++ = DDP_TELEMETRY_VERSION;
+        p = DDPProtocol::putBE16(p, SIZE);
+        const uint32_t counters[] = {
+            uptimeMs, packetsReceived, packetsProcessed,
+            dropsQueueFull, dropsParse, dropsStale, packetsRejected,
+            framesShown, framesIncomplete,
+            sequenceGaps, sequenceMissing, sequenceDuplicates, sequenceLate,
+            framesScheduled, framesLate,
+            outputShows, outputWaits, outputWaitMicros, renderMicros,
+        };
+        for (uint32_t value : counters) {
+            p = DDPProtocol::putBE32(p, value);
+        }
+        p = DDPProtocol::putBE16(p, queueUsage);
+        p = DDPProtocol::putBE16(p, frameRate);
+        p = DDPProtocol::putBE32(p, dropsCobs);
+        p = DDPProtocol::putBE32(p, rejectedDest);
+        p = DDPProtocol::putBE32(p, rejectedRange);
+        p = DDPProtocol::putBE32(p, rejectedConfig);
+        p = DDPProtocol::putBE32(p, logDropped);
+        p = DDPProtocol::putBE32(p, rxOverrunBytes);
+        return p - out;
+    }
+};
@@ -1,13 +1,30 @@
 #pragma once
-#include <Arduino.h>
+#include <Platform.h>
+
+// Strip driver: NeoPixel on the board, an in-memory capture on the host
+#if DDP_PLATFORM == DDP_PLATFORM_HOST
+#include <CaptureStrip.h>
+typedef CaptureStrip OrbDriver;
+#else
 #include <Adafruit_NeoPixel.h>
+typedef Adafruit_NeoPixel OrbDriver;
+#endif
 
 // Orb preset configurations
 #define ORB_PRESET_PICO 0
 
+// Default strip color order and speed (WS2812B)
+#ifndef ORB_PIXEL_TYPE
+#define ORB_PIXEL_TYPE (NEO_GRB + NEO_KHZ800)
+#endif
+
 /**
  * Orb - Simple LED controller wrapper for NeoPixel strips
  * Provides a simple interface for controlling WS2812B LED strips
+ *
+ * A plain Orb drives ORB_PIXEL_TYPE strips. Other color orders and RGBW
+ * strips use OrbStrip<ORDER> (see Orb::create()), which fixes the wire
+ * layout at compile time for pixelsWriteDithered().
  */
 class Orb {
 public:
@@ -17,11 +34,18 @@ public:
      * @param numLEDs Number of LEDs in the strip
      * @param pin GPIO pin for LED data
      */
-    Orb(uint8_t preset = ORB_PRESET_PICO, uint16_t numLEDs = 100, uint8_t pin = 16)
-        : numLEDs(numLEDs), pin(pin), brightness(255) {
-        // Create NeoPixel object (GRB for WS2812B)
-        pixels = new Adafruit_NeoPixel(numLEDs, pin, NEO_GRB + NEO_KHZ800);
-    }
+    Orb([[maybe_unused]] uint8_t preset = ORB_PRESET_PICO, uint16_t numLEDs = 100, uint8_t pin = 16)
+        : Orb(numLEDs, pin, ORB_PIXEL_TYPE) {}
+    
+    /**
+     * Create an Orb for a given pixel type
+     * @param numLEDs Number of LEDs in the strip
+     * @param pin GPIO pin for LED data
+     * @param type NEO_* color order plus speed, e.g. NEO_GRBW + NEO_KHZ800
+     * @return New Orb; an unsupported color order falls back to the order of
+     *         ORB_PIXEL_TYPE, keeping the requested speed
+     */
+    static Orb* create(uint16_t numLEDs, uint8_t pin, neoPixelType type);
     
     /**
      * Initialize the LED strip
@@ -52,6 +76,26 @@ public:
         }
     }
     
+    /**
+     * Write a run of 8.8 fixed point pixels with temporal dithering
+     * Each element is scaled and reduced to 8 bits with first-order error
+     * diffusion over time: the fraction dropped on this refresh is carried
+     * in residual and added on the next, so repeated refreshes average out
+     * to the full precision level. Writes the strip buffer in wire order in
+     * one loop, instead of packing and unpacking a color through
+     * setPixelColor() for every pixel, and bypasses setBrightness().
+     * @param index First pixel index (0-based)
+     * @param levels Source pixels, getBytesPerPixel() elements each in
+     *               R, G, B[, W] order, 255.0 = 0xFF00
+     * @param count Number of pixels; clipped to the strip length
+     * @param scale Brightness scale, 256 = unchanged
+     * @param residual Dither state, one byte per source element
+     */
+    virtual void pixelsWriteDithered(uint16_t index, const uint16_t* levels, uint16_t count,
+                                     uint16_t scale, uint8_t* residual) {
+        writeDithered<ORB_PIXEL_TYPE>(index, levels, count, scale, residual);
+    }
+    
     /**
      * Update the LED strip display
      * Call this after setting pixel colors to show changes
@@ -95,6 +139,23 @@ public:
         return 0;
     }
     
+    /**
+     * Get the raw pixel buffer
+     * Bytes are in strip wire order (GRB for WS2812B), 3 or 4 per LED, and
+     * are what pixelsShow() sends.
+     * @return Pixel buffer, nullptr if not allocated
+     */
+    uint8_t* getPixels() {
+        return pixels ? pixels->getPixels() : nullptr;
+    }
+    
+    /**
+     * Get size of the raw pixel buffer in bytes
+     */
+    size_t getPixelBytes() const {
+        return pixels ? (size_t)numLEDs * bytesPerPixel : 0;
+    }
+    
     /**
      * Fill all pixels with a color
      * @param r Red value (0-255)
@@ -107,10 +168,17 @@ public:
         }
     }
     
+    /**
+     * Get bytes per LED on the wire (3 for RGB, 4 for RGBW)
+     */
+    uint8_t getBytesPerPixel() const {
+        return bytesPerPixel;
+    }
+    
     /**
      * Destructor
      */
-    ~Orb() {
+    virtual ~Orb() {
         if (pixels) {
             delete pixels;
         }
@@ -120,7 +188,102 @@ public:
     uint16_t numLEDs;
     uint8_t pin;
     
+protected:
+    /**
+     * Constructor for a specific pixel type (see OrbStrip)
+     */
+    Orb(uint16_t numLEDs, uint8_t pin, neoPixelType type)
+        : numLEDs(numLEDs), pin(pin), bytesPerPixel(pixelBytes(type)), brightness(255) {
+        pixels = new OrbDriver(numLEDs, pin, type);
+    }
+    
+    /**
+     * Dithered write with the wire layout of ORDER fixed at compile time
+     */
+    template<neoPixelType ORDER>
+    void writeDithered(uint16_t index, const uint16_t* levels, uint16_t count, uint16_t scale,
+                       uint8_t* residual) {
+        constexpr uint8_t STRIDE = pixelBytes(ORDER);
+        constexpr uint8_t OFFSETS[4] = {
+            (ORDER >> 4) & 3, (ORDER >> 2) & 3, ORDER & 3, (ORDER >> 6) & 3
+        };
+
+        if (!pixels || index >= numLEDs) {
+            return;
+        }
+        if (count > numLEDs - index) {
+            count = numLEDs - index;
+        }
+
+        uint8_t* out = pixels->getPixels() + index * STRIDE;
+        for (uint16_t i = 0; i < count; i++) {
+            for (uint8_t c = 0; c < STRIDE; c++) {
+                // At most 0xFF00 + 0xFF, so the integer part never overflows
+                uint32_t v = ((levels[c] * (uint32_t)scale) >> 8) + residual[c];
+                out[OFFSETS[c]] = v >> 8;
+                residual[c] = v & 0xFF;
+            }
+            levels += STRIDE;
+            residual += STRIDE;
+            out += STRIDE;
+        }
+    }
+    
+    /**
+     * Get bytes per LED for a pixel type
+     * Like Adafruit_NeoPixel, a white offset equal to the red offset means
+     * there is no white element.
+     */
+    static constexpr uint8_t pixelBytes(neoPixelType type) {
+        return (((type >> 6) & 3) == ((type >> 4) & 3)) ? 3 : 4;
+    }
+    
 private:
-    Adafruit_NeoPixel* pixels;
+    uint8_t bytesPerPixel;
+    OrbDriver* pixels;
     uint8_t brightness;
 };
+
+/**
+ * Orb with its color order fixed at compile time
+ * @tparam ORDER NEO_* color order (NEO_RGB, NEO_GRBW, ...), without speed bits
+ */
+template<neoPixelType ORDER>
+class OrbStrip : public Orb {
+public:
+    /**
+     * Constructor
+     * @param numLEDs Number of LEDs in the strip
+     * @param pin GPIO pin for LED data
+     * @param speed NEO_KHZ800 or NEO_KHZ400
+     */
+    OrbStrip(uint16_t numLEDs, uint8_t pin, neoPixelType speed = NEO_KHZ800)
+        : Orb(numLEDs, pin, ORDER + speed) {}
+    
+    void pixelsWriteDithered(uint16_t index, const uint16_t* levels, uint16_t count,
+                             uint16_t scale, uint8_t* residual) override {
+        writeDithered<ORDER>(index, levels, count, scale, residual);
+    }
+};
+
+inline Orb* Orb::create(uint16_t numLEDs, uint8_t pin, neoPixelType type) {
+    neoPixelType speed = type & ~(neoPixelType)0xFF;
+    switch (type & 0xFF) {
+        case NEO_RGB:  return new OrbStrip<NEO_RGB>(numLEDs, pin, speed);
+        case NEO_RBG:  return new OrbStrip<NEO_RBG>(numLEDs, pin, speed);
+        case NEO_GRB:  return new OrbStrip<NEO_GRB>(numLEDs, pin, speed);
+        case NEO_GBR:  return new OrbStrip<NEO_GBR>(numLEDs, pin, speed);
+        case NEO_BRG:  return new OrbStrip<NEO_BRG>(numLEDs, pin, speed);
+        case NEO_BGR:  return new OrbStrip<NEO_BGR>(numLEDs, pin, speed);
+        case NEO_RGBW: return new OrbStrip<NEO_RGBW>(numLEDs, pin, speed);
+        case NEO_GRBW: return new OrbStrip<NEO_GRBW>(numLEDs, pin, speed);
+        default:
+            // Keep the requested speed, only the color order falls back
+            Serial.print("[Orb Warn] Unsupported color order 0x");
+            Serial.print(type & 0xFF, HEX);
+            Serial.print(" on pin ");
+            Serial.print(pin);
+            Serial.println(", using the ORB_PIXEL_TYPE order");
+            return new OrbStrip<ORB_PIXEL_TYPE & 0xFF>(numLEDs, pin, speed);
+    }
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include "Platform.h"
+
+// NEO_* pixel types, same encoding as Adafruit_NeoPixel: the offsets of
+// W, R, G and B in the wire order, two bits each. W equal to R means RGB.
+typedef uint16_t neoPixelType;
+
+#define NEO_RGB  ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_RBG  ((0 << 6) | (0 << 4) | (2 << 2) | (1))
+#define NEO_GRB  ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_GBR  ((2 << 6) | (2 << 4) | (0 << 2) | (1))
+#define NEO_BRG  ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_BGR  ((2 << 6) | (2 << 4) | (1 << 2) | (0))
+#define NEO_RGBW ((3 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRBW ((3 << 6) | (1 << 4) | (0 << 2) | (2))
+
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+// Highest GPIO number a strip can be looked up by
+#define CAPTURE_MAX_PINS 48
+
+/**
+ * LED sink of the host build
+ * Stands in for Adafruit_NeoPixel with the same pixel buffer layout and
+ * the calls Orb makes. show() copies the buffer to a capture instead of
+ * sending it, so a host program can check what would have been on the
+ * wire; find() looks a strip up by its pin.
+ */
+class CaptureStrip {
+public:
+    CaptureStrip(uint16_t numLEDs, int16_t pin, neoPixelType type)
+        : numLEDs(numLEDs), pin(pin), brightness(255), showCount(0), lastShowMicros(0) {
+        wOffset = (type >> 6) & 3;
+        rOffset = (type >> 4) & 3;
+        gOffset = (type >> 2) & 3;
+        bOffset = type & 3;
+        bytesPerPixel = (wOffset == rOffset) ? 3 : 4;
+        pixels.assign((size_t)numLEDs * bytesPerPixel, 0);
+        shown.assign(pixels.size(), 0);
+        if (pin >= 0 && pin < CAPTURE_MAX_PINS) {
+            registry()[pin] = this;
+        }
+    }
+
+    ~CaptureStrip() {
+        if (pin >= 0 && pin < CAPTURE_MAX_PINS && registry()[pin] == this) {
+            registry()[pin] = nullptr;
+        }
+    }
+
+    /**
+     * Find the strip on a pin
+     * @return Strip, nullptr if none was created on it
+     */
+    static CaptureStrip* find(uint8_t pin) {
+        return pin < CAPTURE_MAX_PINS ? registry()[pin] : nullptr;
+    }
+
+    void begin() {}
+
+    /**
+     * Capture the pixel buffer as shown
+     */
+    void show() {
+        shown = pixels;
+        showCount++;
+        lastShowMicros = micros();
+    }
+
+    bool canShow() const {
+        return true;
+    }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+        return ((uint32_t)w << 24) | Color(r, g, b);
+    }
+
+    /**
+     * Set a pixel, scaled by the brightness set at the time
+     */
+    void setPixelColor(uint16_t index, uint32_t color) {
+        if (index >= numLEDs) {
+            return;
+        }
+        uint8_t* p = &pixels[(size_t)index * bytesPerPixel];
+        p[rOffset] = scale(color >> 16);
+        p[gOffset] = scale(color >> 8);
+        p[bOffset] = scale(color);
+        if (bytesPerPixel == 4) {
+            p[wOffset] = scale(color >> 24);
+        }
+    }
+
+    uint32_t getPixelColor(uint16_t index) const {
+        if (index >= numLEDs) {
+            return 0;
+        }
+        const uint8_t* p = &pixels[(size_t)index * bytesPerPixel];
+        uint32_t color = Color(p[rOffset], p[gOffset], p[bOffset]);
+        return bytesPerPixel == 4 ? color | ((uint32_t)p[wOffset] << 24) : color;
+    }
+
+    void fill(uint32_t color = 0, uint16_t first = 0, uint16_t count = 0) {
+        uint16_t end = (count == 0 || first + count > numLEDs) ? numLEDs : first + count;
+        for (uint16_t i = first; i < end; i++) {
+            setPixelColor(i, color);
+        }
+    }
+
+    void clear() {
+        std::fill(pixels.begin(), pixels.end(), 0);
+    }
+
+    void setBrightness(uint8_t value) {
+        brightness = value;
+    }
+
+    uint8_t getBrightness() const {
+        return brightness;
+    }
+
+    uint8_t* getPixels() {
+        return pixels.data();
+    }
+
+    uint16_t numPixels() const {
+        return numLEDs;
+    }
+
+    /**
+     * Get the buffer captured by the last show(), in wire order
+     */
+    const uint8_t* getShown() const {
+        return shown.data();
+    }
+
+    /**
+     * Get the size of the captured buffer in bytes
+     */
+    size_t getShownBytes() const {
+        return shown.size();
+    }
+
+    /**
+     * Get the number of show() calls
+     */
+    uint32_t getShowCount() const {
+        return showCount;
+    }
+
+    /**
+     * Get micros() at the last show()
+     */
+    uint32_t getLastShowMicros() const {
+        return lastShowMicros;
+    }
+
+private:
+    static CaptureStrip** registry() {
+        static CaptureStrip* strips[CAPTURE_MAX_PINS] = {};
+        return strips;
+    }
+
+    uint8_t scale(uint32_t value) const {
+        uint8_t v = value & 0xFF;
+        return brightness == 255 ? v : (v * (brightness + 1)) >> 8;
+    }
+
+    uint16_t numLEDs;
+    int16_t pin;
+    uint8_t bytesPerPixel;
+    uint8_t rOffset;
+    uint8_t gOffset;
+    uint8_t bOffset;
+    uint8_t wOffset;
+    uint8_t brightness;
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> shown;
+    uint32_t showCount;
+    uint32_t lastShowMicros;
+};
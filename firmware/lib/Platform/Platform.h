@@ -0,0 +1,80 @@
+#pragma once
+
+// Target platform selection
+#define DDP_PLATFORM_PICO 0  // arduino-pico on RP2040 / RP2350 (default under Arduino)
+#define DDP_PLATFORM_HOST 1  // Desktop build: std::thread as Core 1, strips captured in memory
+
+#ifndef DDP_PLATFORM
+#if defined(ARDUINO)
+#define DDP_PLATFORM DDP_PLATFORM_PICO
+#else
+#define DDP_PLATFORM DDP_PLATFORM_HOST
+#endif
+#endif
+
+/**
+ * Platform layer
+ * The few services the DDP pipeline needs from the board, so the same
+ * code runs on the Pico and as a host program:
+ * - Clock and serial link: the Arduino millis(), micros(), delay() and
+ *   Serial; the host backend provides that subset (PlatformHost.h), with
+ *   the serial receive side fed by HostSerial::inject()
+ * - PlatformMutex: lock shared by both cores
+ * - platformLaunchCore1() / platformStopCore1(): run the receive loop on
+ *   the second core, or on a thread on the host
+ * - platformIdle(): busy-wait hint for polling loops
+ * - LED sink: Adafruit_NeoPixel on the Pico, CaptureStrip on the host
+ *   (selected in Orb.h)
+ * Atomics are std::atomic on both.
+ */
+#if DDP_PLATFORM == DDP_PLATFORM_HOST
+#include "PlatformHost.h"
+#else
+#include <Arduino.h>
+#include <pico/multicore.h>
+#include <pico/mutex.h>
+
+/**
+ * Mutex shared between the cores
+ */
+class PlatformMutex {
+public:
+    PlatformMutex() {
+        mutex_init(&mutex);
+    }
+
+    void lock() {
+        mutex_enter_blocking(&mutex);
+    }
+
+    void unlock() {
+        mutex_exit(&mutex);
+    }
+
+private:
+    mutex_t mutex;
+};
+
+/**
+ * Start a function on Core 1
+ * @param entry Entry point; Core 1 stops when it returns
+ */
+inline void platformLaunchCore1(void (*entry)()) {
+    multicore_launch_core1(entry);
+}
+
+/**
+ * Stop Core 1
+ * The receive loop should already have been told to finish.
+ */
+inline void platformStopCore1() {
+    multicore_reset_core1();
+}
+
+/**
+ * Busy-wait hint for polling loops
+ */
+inline void platformIdle() {
+    tight_loop_contents();
+}
+#endif
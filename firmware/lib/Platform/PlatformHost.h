@@ -0,0 +1,291 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Host backend of the platform layer (see Platform.h)
+ * Provides the part of the Arduino API the DDP pipeline uses, so the
+ * library builds as a desktop program: a clock counting from program
+ * start, and a Serial whose receive side is fed by the host program and
+ * whose transmit side is captured (and optionally echoed to a FILE*).
+ * The clock wraps at 32 bits like the Pico's.
+ */
+
+using std::max;
+using std::min;
+
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+
+/**
+ * Time base of the host clock
+ */
+inline std::chrono::steady_clock::time_point platformClockStart() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+inline uint32_t micros() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - platformClockStart()).count();
+}
+
+inline uint32_t millis() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - platformClockStart()).count();
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+inline void yield() {
+    std::this_thread::yield();
+}
+
+/**
+ * Byte stream read by StreamRxSource
+ */
+class Stream {
+public:
+    virtual ~Stream() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual size_t readBytes(uint8_t* buffer, size_t length) = 0;
+};
+
+/**
+ * Serial link of the host build
+ * inject() stands in for the USB host sending bytes; everything the
+ * controller prints or sends is kept until takeOutput(). Both sides are
+ * locked, so the injecting thread and Core 1's reads can overlap.
+ */
+class HostSerial : public Stream {
+public:
+    // Transmit space reported to the controller; the host never blocks
+    static constexpr int TX_SPACE = 4096;
+
+    HostSerial() : echo(nullptr) {}
+
+    void begin(unsigned long) {}
+
+    explicit operator bool() const {
+        return true;
+    }
+
+    /**
+     * Queue bytes for the receive side
+     * @param data Bytes as the host would send them (COBS frames)
+     * @param length Number of bytes
+     */
+    void inject(const uint8_t* data, size_t length) {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        received.insert(received.end(), data, data + length);
+    }
+
+    int available() override {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        return (int)received.size();
+    }
+
+    int read() override {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        if (received.empty()) {
+            return -1;
+        }
+        uint8_t value = received.front();
+        received.pop_front();
+        return value;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) override {
+        std::lock_guard<std::mutex> lock(rxMutex);
+        size_t n = min(length, received.size());
+        std::copy(received.begin(), received.begin() + n, buffer);
+        received.erase(received.begin(), received.begin() + n);
+        return n;
+    }
+
+    /**
+     * Also write everything sent to a file (e.g. stdout)
+     * @param file Destination, nullptr to only capture
+     */
+    void setEcho(FILE* file) {
+        std::lock_guard<std::mutex> lock(txMutex);
+        echo = file;
+    }
+
+    /**
+     * Take the bytes sent since the last call
+     */
+    std::vector<uint8_t> takeOutput() {
+        std::lock_guard<std::mutex> lock(txMutex);
+        std::vector<uint8_t> out;
+        out.swap(transmitted);
+        return out;
+    }
+
+    int availableForWrite() {
+        return TX_SPACE;
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(txMutex);
+        if (echo) {
+            fflush(echo);
+        }
+    }
+
+    size_t write(uint8_t value) {
+        return write(&value, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        std::lock_guard<std::mutex> lock(txMutex);
+        transmitted.insert(transmitted.end(), data, data + length);
+        if (echo) {
+            fwrite(data, 1, length, echo);
+        }
+        return length;
+    }
+
+    size_t print(const char* text) {
+        return write((const uint8_t*)text, strlen(text));
+    }
+
+    size_t print(char c) {
+        return write((uint8_t)c);
+    }
+
+    template<typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    size_t print(T value, int base = DEC) {
+        char text[72];
+        char* p = text + sizeof(text);
+        *--p = 0;
+        bool negative = std::is_signed<T>::value && base == DEC && value < 0;
+        unsigned long long n = negative ? 0 - (unsigned long long)value
+                                        : (unsigned long long)(typename std::make_unsigned<T>::type)value;
+        do {
+            uint8_t digit = n % base;
+            *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+            n /= base;
+        } while (n);
+        if (negative) {
+            *--p = '-';
+        }
+        return print(p);
+    }
+
+    size_t print(double value, int digits = 2) {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*f", digits, value);
+        return print(text);
+    }
+
+    size_t println() {
+        return print("\r\n");
+    }
+
+    template<typename... Args>
+    size_t println(Args... args) {
+        size_t n = print(args...);
+        return n + println();
+    }
+
+    __attribute__((format(printf, 2, 3))) size_t printf(const char* format, ...) {
+        char text[256];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (n < 0) {
+            return 0;
+        }
+        if ((size_t)n < sizeof(text)) {
+            return write((const uint8_t*)text, n);
+        }
+        std::vector<char> longText(n + 1);
+        va_start(args, format);
+        vsnprintf(longText.data(), longText.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)longText.data(), n);
+    }
+
+private:
+    std::mutex rxMutex;
+    std::deque<uint8_t> received;
+    std::mutex txMutex;
+    std::vector<uint8_t> transmitted;
+    FILE* echo;
+};
+
+inline HostSerial Serial;
+
+/**
+ * Mutex shared between the cores
+ */
+class PlatformMutex {
+public:
+    void lock() {
+        mutex.lock();
+    }
+
+    void unlock() {
+        mutex.unlock();
+    }
+
+private:
+    std::mutex mutex;
+};
+
+/**
+ * Thread standing in for Core 1
+ */
+inline std::thread& platformCore1() {
+    static std::thread thread;
+    return thread;
+}
+
+/**
+ * Start a function on the Core 1 thread
+ * @param entry Entry point; the thread ends when it returns
+ */
+inline void platformLaunchCore1(void (*entry)()) {
+    platformCore1() = std::thread(entry);
+}
+
+/**
+ * Wait for the Core 1 thread to finish
+ * The receive loop must already have been told to finish.
+ */
+inline void platformStopCore1() {
+    if (platformCore1().joinable()) {
+        platformCore1().join();
+    }
+}
+
+/**
+ * Busy-wait hint for polling loops
+ * Sleeps briefly rather than spinning, so the Core 1 thread does not
+ * starve the main thread on a host with fewer free cores than threads.
+ */
+inline void platformIdle() {
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+}
@@ -28,15 +28,16 @@
 
 // LED Channel Configurations (predefined pins for each channel)
 // Up to 8 channels mapped to Pico GPIOs (DDP destination IDs 1-8)
+// Each channel sets its own color order, e.g. NEO_GRBW + NEO_KHZ800 for SK6812 RGBW
 const LEDChannel channelConfigs[] = {
-    {43, 16, nullptr, nullptr},  // Channel 1: 43 LEDs on GP16 (default strip)
-    {50, 17, nullptr, nullptr},  // Channel 2: 50 LEDs on GP17
-    {50, 18, nullptr, nullptr},  // Channel 3: 50 LEDs on GP18
-    {50, 19, nullptr, nullptr},  // Channel 4: 50 LEDs on GP19
-    {50, 13, nullptr, nullptr},  // Channel 5: 50 LEDs on GP13
-    {50, 12, nullptr, nullptr},  // Channel 6: 50 LEDs on GP12
-    {50, 11, nullptr, nullptr},  // Channel 7: 50 LEDs on GP11
-    {50, 10, nullptr, nullptr}   // Channel 8: 50 LEDs on GP10
+    {43, 16, NEO_GRB + NEO_KHZ800},  // Channel 1: 43 LEDs on GP16 (default strip)
+    {50, 17, NEO_GRB + NEO_KHZ800},  // Channel 2: 50 LEDs on GP17
+    {50, 18, NEO_GRB + NEO_KHZ800},  // Channel 3: 50 LEDs on GP18
+    {50, 19, NEO_GRB + NEO_KHZ800},  // Channel 4: 50 LEDs on GP19
+    {50, 13, NEO_GRB + NEO_KHZ800},  // Channel 5: 50 LEDs on GP13
+    {50, 12, NEO_GRB + NEO_KHZ800},  // Channel 6: 50 LEDs on GP12
+    {50, 11, NEO_GRB + NEO_KHZ800},  // Channel 7: 50 LEDs on GP11
+    {50, 10, NEO_GRB + NEO_KHZ800}   // Channel 8: 50 LEDs on GP10
 };
 const uint8_t numChannels = sizeof(channelConfigs) / sizeof(channelConfigs[0]);
 
@@ -0,0 +1,155 @@
+/**
+ * BitPlane test
+ *
+ * Checks transpose8() against a per-bit reference on random 8x8 inputs,
+ * then encodes lanes of unequal length and reads every lane back out of
+ * the GPIO words: each must match its bytes, in wire order, followed by
+ * zero padding. The lanes are the strip buffers of RGB and RGBW Orbs, so
+ * the colour order on the wire is checked as well.
+ *
+ * Built by firmware/CMakeLists.txt and run by ctest.
+ *
+ * Usage:
+ *   ./test_bitplane [seed]
+ */
+
+#include <Platform.h>
+#include <Orb.h>
+#include <BitPlane.h>
+
+#define TEST_TRANSPOSES 100000
+
+// Board layout (src/main.cpp): lanes on GP10-GP19, not in pin order
+static const uint8_t lanePins[8] = {16, 17, 18, 19, 13, 12, 11, 10};
+#define TEST_BASE_PIN 10
+
+/**
+ * xorshift32, so runs repeat for a given seed
+ */
+static uint32_t randomState;
+
+static uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+static bool testTranspose() {
+    for (uint32_t n = 0; n < TEST_TRANSPOSES; n++) {
+        uint8_t in[8];
+        for (uint8_t lane = 0; lane < 8; lane++) {
+            in[lane] = (uint8_t)nextRandom();
+        }
+        uint8_t out[8];
+        BitPlane::transpose8(in, out);
+
+        for (uint8_t b = 0; b < 8; b++) {
+            uint8_t expected = 0;
+            for (uint8_t lane = 0; lane < 8; lane++) {
+                expected |= ((in[lane] >> (7 - b)) & 1) << lane;
+            }
+            if (out[b] != expected) {
+                printf("FAIL: transpose8 bit %u is %02x, expected %02x (input %02x %02x %02x %02x %02x %02x %02x %02x)\n",
+                       b, out[b], expected, in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7]);
+                return false;
+            }
+        }
+    }
+    printf("transpose8: %u random inputs PASSED\n", TEST_TRANSPOSES);
+    return true;
+}
+
+/**
+ * Read byte i of a lane back out of the encoded words
+ */
+static uint8_t decodeLaneByte(const uint32_t* words, size_t i, uint8_t pin) {
+    uint8_t value = 0;
+    for (uint8_t b = 0; b < 8; b++) {
+        uint32_t word = words[i * BitPlane::WORDS_PER_BYTE + b / 2];
+        uint16_t gpio = (b & 1) ? word >> 16 : word & 0xFFFF;
+        value = (value << 1) | ((gpio >> (pin - TEST_BASE_PIN)) & 1);
+    }
+    return value;
+}
+
+static bool testEncode() {
+    // Unequal lengths and both pixel sizes; the longest lane sets the length
+    static const struct {
+        uint16_t numLEDs;
+        neoPixelType type;
+    } strips[8] = {
+        {43, NEO_GRB + NEO_KHZ800},  {50, NEO_GRB + NEO_KHZ800},  {7, NEO_RGB + NEO_KHZ800},
+        {50, NEO_GRBW + NEO_KHZ800}, {1, NEO_BGR + NEO_KHZ800},   {32, NEO_RGBW + NEO_KHZ800},
+        {50, NEO_GRB + NEO_KHZ800},  {12, NEO_GRBW + NEO_KHZ800},
+    };
+
+    Orb* orbs[8];
+    const uint8_t* lanes[8];
+    size_t lengths[8];
+    size_t length = 0;
+    for (uint8_t lane = 0; lane < 8; lane++) {
+        orbs[lane] = Orb::create(strips[lane].numLEDs, lanePins[lane], strips[lane].type);
+        uint8_t elements = orbs[lane]->getBytesPerPixel();
+        std::vector<uint16_t> levels((size_t)strips[lane].numLEDs * elements);
+        for (uint16_t& level : levels) {
+            level = (uint16_t)((nextRandom() & 0xFF) << 8);
+        }
+        // Known colours on pixel 0 to pin the wire order down
+        const uint8_t first[4] = {0x11, 0x22, 0x33, 0x44};
+        for (uint8_t e = 0; e < elements; e++) {
+            levels[e] = first[e] << 8;
+        }
+        std::vector<uint8_t> residual(levels.size(), 0);
+        orbs[lane]->pixelsWriteDithered(0, levels.data(), strips[lane].numLEDs, 256, residual.data());
+
+        lanes[lane] = orbs[lane]->getPixels();
+        lengths[lane] = orbs[lane]->getPixelBytes();
+        length = max(length, lengths[lane]);
+    }
+
+    uint16_t map[256];
+    BitPlane::buildPinMap(lanePins, 8, TEST_BASE_PIN, map);
+    std::vector<uint32_t> words(length * BitPlane::WORDS_PER_BYTE);
+    BitPlane::encode(lanes, lengths, 8, length, map, words.data());
+
+    bool ok = true;
+    for (uint8_t lane = 0; lane < 8 && ok; lane++) {
+        // Pixel 0 in wire order: R, G, B and W land at the type's offsets
+        neoPixelType type = strips[lane].type;
+        const uint8_t offsets[4] = {(uint8_t)((type >> 4) & 3), (uint8_t)((type >> 2) & 3), (uint8_t)(type & 3),
+                                    (uint8_t)((type >> 6) & 3)};
+        for (uint8_t e = 0; e < orbs[lane]->getBytesPerPixel(); e++) {
+            uint8_t shown = decodeLaneByte(words.data(), offsets[e], lanePins[lane]);
+            if (shown != 0x11 * (e + 1)) {
+                printf("FAIL: lane %u element %u is %02x on the wire at byte %u, expected %02x\n", lane, e, shown,
+                       offsets[e], 0x11 * (e + 1));
+                ok = false;
+            }
+        }
+        for (size_t i = 0; i < length && ok; i++) {
+            uint8_t expected = i < lengths[lane] ? lanes[lane][i] : 0;
+            uint8_t shown = decodeLaneByte(words.data(), i, lanePins[lane]);
+            if (shown != expected) {
+                printf("FAIL: lane %u byte %zu of %zu is %02x, expected %02x\n", lane, i, lengths[lane], shown,
+                       expected);
+                ok = false;
+            }
+        }
+    }
+    for (Orb* orb : orbs) {
+        delete orb;
+    }
+    printf("encode: 8 lanes of 3-200 bytes, RGB and RGBW: %s\n", ok ? "PASSED" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    randomState = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1;
+    if (randomState == 0) {
+        randomState = 1;
+    }
+    bool ok = testTranspose();
+    ok = testEncode() && ok;
+    return ok ? 0 : 1;
+}
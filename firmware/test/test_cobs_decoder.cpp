@@ -0,0 +1,186 @@
+/**
+ * COBSDecoder block/byte equivalence test
+ *
+ * Encodes a stream of random frames, some longer than the decoder takes,
+ * then feeds it once through processByte() and once through
+ * processBlock() in random chunk sizes. Both must decode exactly the
+ * frames that fit, in order, and count the same errors. Chunks are cut so
+ * that delimiters land on either side of a chunk boundary. Runs in both
+ * decoder modes.
+ *
+ * Built by firmware/CMakeLists.txt and run by ctest.
+ *
+ * Usage:
+ *   ./test_cobs_decoder [seed]
+ */
+
+#include <Platform.h>
+#include <COBSEncoder.h>
+#include <COBSDecoder.h>
+
+#define TEST_MAX_FRAME 1500
+#define TEST_FRAMES 3000
+#define TEST_MAX_CHUNK 700
+
+// Longest payload that fits in either mode: buffered mode holds the
+// encoded frame, which adds one byte per 254 plus the leading code
+#define TEST_FIT_LENGTH (TEST_MAX_FRAME - TEST_MAX_FRAME / 254 - 1)
+
+typedef std::vector<std::vector<uint8_t>> FrameList;
+
+/**
+ * xorshift32, so runs repeat for a given seed
+ */
+static uint32_t randomState;
+
+static uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+static uint32_t randomBelow(uint32_t n) {
+    return nextRandom() % n;
+}
+
+/**
+ * Build the encoded stream and the frames a correct decoder returns from it
+ * One frame in 50 is oversized and must be dropped.
+ */
+static void buildStream(std::vector<uint8_t>& stream, FrameList& expected) {
+    for (uint32_t f = 0; f < TEST_FRAMES; f++) {
+        bool oversized = randomBelow(50) == 0;
+        size_t length = oversized ? TEST_MAX_FRAME + 1 + randomBelow(TEST_MAX_FRAME)
+                                  : 1 + randomBelow(TEST_FIT_LENGTH);
+        // Alternate between pixel-like data and data dense in zeros
+        uint32_t zeroOdds = (f & 1) ? 8 : 200;
+        std::vector<uint8_t> frame(length);
+        for (size_t i = 0; i < length; i++) {
+            frame[i] = randomBelow(zeroOdds) == 0 ? 0 : (uint8_t)(1 + randomBelow(255));
+        }
+
+        size_t start = stream.size();
+        stream.resize(start + COBSEncoder::maxEncodedLength(length));
+        size_t encoded = COBSEncoder::encode(frame.data(), length, stream.data() + start);
+        stream.resize(start + encoded);
+        stream.push_back(0x00);
+        // Repeated delimiters are empty frames and decode to nothing
+        if (randomBelow(20) == 0) {
+            stream.push_back(0x00);
+        }
+
+        if (!oversized) {
+            expected.push_back(frame);
+        }
+    }
+}
+
+static void decodeByBytes(COBSDecoder& decoder, const std::vector<uint8_t>& stream, FrameList& frames) {
+    for (uint8_t byte : stream) {
+        if (decoder.processByte(byte)) {
+            const uint8_t* frame = decoder.getFrame();
+            frames.emplace_back(frame, frame + decoder.getFrameLength());
+        }
+    }
+}
+
+/**
+ * Feed the stream to processBlock() in random chunks
+ * Some chunks end right before a delimiter and some right after one.
+ */
+static void decodeByBlocks(COBSDecoder& decoder, const std::vector<uint8_t>& stream, FrameList& frames,
+                           uint32_t& cutsBefore, uint32_t& cutsAfter) {
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        size_t chunk = min((size_t)(1 + randomBelow(TEST_MAX_CHUNK)), stream.size() - pos);
+        if (randomBelow(3) == 0) {
+            const uint8_t* delimiter = (const uint8_t*)memchr(stream.data() + pos, 0x00, chunk);
+            if (delimiter && delimiter > stream.data() + pos) {
+                size_t at = delimiter - (stream.data() + pos);
+                chunk = randomBelow(2) ? at : at + 1;
+            }
+        }
+        if (stream[pos + chunk - 1] == 0x00) {
+            cutsAfter++;
+        } else if (pos + chunk < stream.size() && stream[pos + chunk] == 0x00) {
+            cutsBefore++;
+        }
+
+        const uint8_t* data = stream.data() + pos;
+        size_t remaining = chunk;
+        while (remaining > 0) {
+            bool frameDecoded;
+            size_t consumed = decoder.processBlock(data, remaining, frameDecoded);
+            if (frameDecoded) {
+                const uint8_t* frame = decoder.getFrame();
+                frames.emplace_back(frame, frame + decoder.getFrameLength());
+            }
+            data += consumed;
+            remaining -= consumed;
+        }
+        pos += chunk;
+    }
+}
+
+/**
+ * Compare decoded frames with the expected ones
+ * @return true if they match
+ */
+static bool sameFrames(const char* label, const FrameList& frames, const FrameList& expected) {
+    if (frames.size() != expected.size()) {
+        printf("FAIL: %s decoded %zu frames, expected %zu\n", label, frames.size(), expected.size());
+        return false;
+    }
+    for (size_t f = 0; f < frames.size(); f++) {
+        if (frames[f] != expected[f]) {
+            printf("FAIL: %s frame %zu differs (%zu bytes, expected %zu)\n", label, f, frames[f].size(),
+                   expected[f].size());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool testMode(COBSDecoder::Mode mode, const char* name) {
+    std::vector<uint8_t> stream;
+    FrameList expected;
+    buildStream(stream, expected);
+    uint32_t oversized = TEST_FRAMES - expected.size();
+
+    COBSDecoder byteDecoder(TEST_MAX_FRAME, mode);
+    COBSDecoder blockDecoder(TEST_MAX_FRAME, mode);
+    FrameList byByte, byBlock;
+    uint32_t cutsBefore = 0, cutsAfter = 0;
+    decodeByBytes(byteDecoder, stream, byByte);
+    decodeByBlocks(blockDecoder, stream, byBlock, cutsBefore, cutsAfter);
+
+    bool ok = sameFrames("processByte", byByte, expected);
+    ok = sameFrames("processBlock", byBlock, expected) && ok;
+    if (byteDecoder.getErrorCount() != blockDecoder.getErrorCount()) {
+        printf("FAIL: %u errors by byte, %u by block\n", byteDecoder.getErrorCount(),
+               blockDecoder.getErrorCount());
+        ok = false;
+    }
+    if (oversized == 0 || blockDecoder.getErrorCount() < oversized) {
+        printf("FAIL: %u oversized frames, %u errors\n", oversized, blockDecoder.getErrorCount());
+        ok = false;
+    }
+    if (cutsBefore == 0 || cutsAfter == 0) {
+        printf("FAIL: no chunk boundary next to a delimiter\n");
+        ok = false;
+    }
+    printf("%s: %zu frames, %u oversized, %u/%u chunks cut before/after a delimiter: %s\n", name,
+           expected.size(), oversized, cutsBefore, cutsAfter, ok ? "PASSED" : "FAILED");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    randomState = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1;
+    if (randomState == 0) {
+        randomState = 1;
+    }
+    bool ok = testMode(COBSDecoder::MODE_BUFFERED, "Buffered");
+    ok = testMode(COBSDecoder::MODE_STREAMING, "Streaming") && ok;
+    return ok ? 0 : 1;
+}
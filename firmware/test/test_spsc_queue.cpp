@@ -0,0 +1,115 @@
+/**
+ * SPSCQueue stress test
+ *
+ * A producer thread writes records of varying length through a small
+ * queue, so records wrap constantly, while the main thread consumes them
+ * and checks every byte against what was sent, in order. Alternates
+ * between the copying API (write/read) and the in-place one
+ * (claim/commit, peek/release) on both sides.
+ *
+ * Built by firmware/CMakeLists.txt and run by ctest.
+ *
+ * Usage:
+ *   ./test_spsc_queue [records]   (default 1000000)
+ */
+
+#include <Platform.h>
+#include <SPSCQueue.h>
+
+// Small enough that a few records fill it and every lap wraps
+#define TEST_QUEUE_SIZE 1024
+#define TEST_MAX_RECORD 300
+
+typedef SPSCQueue<TEST_QUEUE_SIZE> TestQueue;
+
+/**
+ * Get the length of record n; covers 1 byte up to TEST_MAX_RECORD
+ */
+static size_t recordLength(uint32_t n) {
+    return 1 + (n * 7919u) % TEST_MAX_RECORD;
+}
+
+/**
+ * Get byte i of record n
+ */
+static uint8_t recordByte(uint32_t n, size_t i) {
+    return (uint8_t)(n * 31u + i * 7u + (n >> 8));
+}
+
+static void produce(TestQueue& queue, uint32_t records) {
+    uint8_t data[TEST_MAX_RECORD];
+    for (uint32_t n = 0; n < records; n++) {
+        size_t length = recordLength(n);
+        if (n & 1) {
+            uint8_t* slot;
+            while (!(slot = queue.claim(length))) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < length; i++) {
+                slot[i] = recordByte(n, i);
+            }
+            queue.commit(length);
+        } else {
+            for (size_t i = 0; i < length; i++) {
+                data[i] = recordByte(n, i);
+            }
+            while (!queue.write(data, length)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+/**
+ * Compare one received record with what record n was
+ * @return true if length and every byte match
+ */
+static bool checkRecord(uint32_t n, const uint8_t* data, size_t length) {
+    if (length != recordLength(n)) {
+        printf("FAIL: record %u is %zu bytes, expected %zu\n", n, length, recordLength(n));
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != recordByte(n, i)) {
+            printf("FAIL: record %u byte %zu is %u, expected %u\n", n, i, data[i], recordByte(n, i));
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t records = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+    static TestQueue queue;
+    std::thread producer(produce, std::ref(queue), records);
+
+    // Keeps consuming after a failure so the producer can finish
+    bool ok = true;
+    uint8_t data[TEST_MAX_RECORD];
+    for (uint32_t n = 0; n < records; n++) {
+        if (n % 3 == 0) {
+            size_t length;
+            while ((length = queue.read(data, sizeof(data))) == 0) {
+                std::this_thread::yield();
+            }
+            ok = ok && checkRecord(n, data, length);
+        } else {
+            size_t length;
+            const uint8_t* record;
+            while (!(record = queue.peek(length))) {
+                std::this_thread::yield();
+            }
+            ok = ok && checkRecord(n, record, length);
+            queue.release();
+        }
+    }
+    producer.join();
+
+    if (ok && queue.available()) {
+        printf("FAIL: queue not empty after %u records\n", records);
+        ok = false;
+    }
+    printf("%u records: %s\n", records, ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}